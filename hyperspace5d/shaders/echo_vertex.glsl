@@ -0,0 +1,71 @@
+#version 450 core
+
+// Instanced echo trail: instance i is the source box offset by i steps.
+// The 5D rotation is linear, so the CPU passes the rotated source and
+// rotated step split into visible and hidden parts; the projection and
+// hidden-dimension effects below mirror Projection5D.
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+uniform vec3 uBaseVisible;
+uniform vec2 uBaseHidden;
+uniform vec3 uStepVisible;
+uniform vec2 uStepHidden;
+uniform vec3 uEchoSize;
+uniform int uFirstEcho;
+
+uniform vec3 uColor;
+uniform vec3 uEchoColorStep;
+uniform float uOpacity;
+uniform float uEchoFade;
+
+uniform float uHiddenDimScale;
+uniform float uHiddenDimAlpha;
+uniform int uUsePerspective;
+
+out vec3 FragPos;
+out vec3 Normal;
+out float ViewDepth;
+out vec3 ObjectColor;
+out float ObjectOpacity;
+out vec3 ObjectTint;
+
+void main()
+{
+    float echo = float(uFirstEcho + gl_InstanceID);
+    
+    vec3 visible = uBaseVisible + uStepVisible * echo;
+    vec2 hidden = uBaseHidden + uStepHidden * echo;
+    float hiddenDepth = length(hidden);
+    
+    // Projection5D::project / calculateScale
+    if (uUsePerspective != 0) {
+        visible *= 1.0 / (1.0 + uHiddenDimScale * hiddenDepth);
+    }
+    float scale = 1.0 / (1.0 + uHiddenDimScale * hiddenDepth * 0.1);
+    
+    FragPos = visible + aPos * uEchoSize * scale;
+    Normal = aNormal;
+    
+    vec4 viewPos = uView * vec4(FragPos, 1.0);
+    ViewDepth = -viewPos.z;
+    
+    // Per-echo fade on top of Projection5D::calculateOpacity
+    float hiddenOpacity = clamp(1.0 - uHiddenDimAlpha * (hiddenDepth / 10.0), 0.1, 1.0);
+    float echoOpacity = clamp(uOpacity + uEchoFade * abs(echo), 0.0, 1.0);
+    ObjectOpacity = echoOpacity * hiddenOpacity;
+    ObjectColor = uColor + uEchoColorStep * echo;
+    
+    // Projection5D::calculateHiddenDimTint
+    vec3 tint = vec3(1.0);
+    tint.r += hidden.x * 0.1;
+    tint.b -= hidden.x * 0.1;
+    tint.g += hidden.y * 0.1;
+    ObjectTint = clamp(tint, vec3(0.5), vec3(1.5));
+    
+    gl_Position = uProjection * viewPos;
+}
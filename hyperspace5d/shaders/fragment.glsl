@@ -4,12 +4,70 @@ out vec4 FragColor;
 
 in vec3 FragPos;
 in vec3 Normal;
+in float ViewDepth;
+in vec3 ObjectColor;
+in float ObjectOpacity;
+in vec3 ObjectTint;
 
-uniform vec3 uColor;
-uniform float uOpacity;
 uniform vec3 uLightPos;
 uniform vec3 uViewPos;
-uniform vec3 uHiddenDimTint;
+
+// Clustered point lights (see ClusteredLighting.hpp)
+struct PointLight {
+    vec4 positionRadius;
+    vec4 colorIntensity;
+};
+
+layout (std430, binding = 0) readonly buffer LightBuffer {
+    PointLight lights[];
+};
+
+layout (std430, binding = 1) readonly buffer ClusterBuffer {
+    uvec2 clusters[];
+};
+
+layout (std430, binding = 2) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
+
+uniform ivec3 uClusterDims;
+uniform vec2 uViewportSize;
+uniform float uClusterNear;
+uniform float uClusterFar;
+uniform int uUseClusteredLights;
+
+vec3 shadePointLights(vec3 norm, vec3 viewDir)
+{
+    vec2 tile = floor(gl_FragCoord.xy / uViewportSize * vec2(uClusterDims.xy));
+    int slice = 0;
+    if (ViewDepth > uClusterNear) {
+        slice = int(log(ViewDepth / uClusterNear) / log(uClusterFar / uClusterNear) * float(uClusterDims.z));
+    }
+    ivec3 cell = clamp(ivec3(tile, slice), ivec3(0), uClusterDims - 1);
+    uvec2 cluster = clusters[(cell.z * uClusterDims.y + cell.y) * uClusterDims.x + cell.x];
+    
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < cluster.y; ++i) {
+        PointLight light = lights[lightIndices[cluster.x + i]];
+        vec3 toLight = light.positionRadius.xyz - FragPos;
+        float dist = length(toLight);
+        float radius = light.positionRadius.w;
+        if (dist >= radius) continue;
+        
+        // Smooth window falloff reaching zero at the radius
+        float ratio = dist / radius;
+        float falloff = (1.0 - ratio * ratio);
+        falloff *= falloff;
+        
+        vec3 lightDir = toLight / max(dist, 1e-4);
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = 0.5 * pow(max(dot(viewDir, reflectDir), 0.0), 32);
+        
+        result += (diff + spec) * falloff * light.colorIntensity.rgb * light.colorIntensity.a;
+    }
+    return result;
+}
 
 void main()
 {
@@ -30,8 +88,13 @@ void main()
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
     vec3 specular = specularStrength * spec * vec3(1.0);
     
+    vec3 lighting = ambient + diffuse + specular;
+    if (uUseClusteredLights != 0) {
+        lighting += shadePointLights(norm, viewDir);
+    }
+    
     // Combine lighting with color and hidden dimension tint
-    vec3 result = (ambient + diffuse + specular) * uColor * uHiddenDimTint;
+    vec3 result = lighting * ObjectColor * ObjectTint;
     
-    FragColor = vec4(result, uOpacity);
+    FragColor = vec4(result, ObjectOpacity);
 }
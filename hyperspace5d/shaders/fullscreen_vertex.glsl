@@ -0,0 +1,13 @@
+#version 450 core
+
+// Single triangle covering the screen, generated from gl_VertexID
+// (drawn with an empty VAO and 3 vertices).
+
+out vec2 ScreenUV;
+
+void main()
+{
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    ScreenUV = pos;
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
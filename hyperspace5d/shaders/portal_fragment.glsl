@@ -0,0 +1,27 @@
+#version 450 core
+
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+in float ViewDepth;
+in vec3 ObjectColor;
+
+// View from the linked portal, rendered into a texture the size of the
+// current render target. Sampled in screen space so it lines up with
+// the surface it's shown on.
+uniform sampler2D uPortalView;
+uniform vec2 uTargetSize;
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / uTargetSize;
+    vec3 remote = texture(uPortalView, uv).rgb;
+    
+    // Tint towards the portal color at glancing angles so the edge reads
+    vec3 norm = normalize(Normal);
+    float rim = 1.0 - abs(norm.y);
+    vec3 result = mix(remote, ObjectColor, 0.15 + 0.35 * rim);
+    
+    FragColor = vec4(result, 1.0);
+}
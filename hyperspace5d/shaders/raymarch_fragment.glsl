@@ -0,0 +1,209 @@
+#version 450 core
+
+// Sphere-traces the visible 3D slice of 5D boxes (see SDFRaymarcher.hpp,
+// which has the CPU version of the same march).
+
+in vec2 ScreenUV;
+out vec4 FragColor;
+
+struct Box {
+    vec4 center;        // x, y, z, w
+    vec4 halfSize;      // x, y, z, w
+    vec4 extra;         // center v, halfSize v
+    vec4 colorOpacity;
+};
+
+layout (std430, binding = 3) readonly buffer BoxBuffer {
+    Box boxes[];
+};
+
+layout (std430, binding = 4) readonly buffer CellBuffer {
+    uvec2 cells[];
+};
+
+layout (std430, binding = 5) readonly buffer CellIndexBuffer {
+    uint cellBoxes[];
+};
+
+uniform mat4 uInvViewProj;
+uniform vec3 uViewPos;
+uniform vec3 uLightPos;
+
+// w[i] = dot(uSliceRows[i], p); uSliceProject[i] maps 5D offsets onto the slice
+uniform vec3 uSliceRows[5];
+uniform vec3 uSliceProject[5];
+
+uniform vec3 uGridMin;
+uniform vec3 uCellSize;
+uniform ivec3 uGridDims;
+
+uniform int uMaxSteps;
+uniform float uHitEpsilon;
+uniform float uFogDensity;
+uniform float uFogFalloff;
+uniform float uFogEdge;
+uniform float uFogStep;
+uniform vec3 uBackground;
+
+void loadBox(uint b, out float center[5], out float halfSize[5])
+{
+    Box box = boxes[b];
+    center = float[5](box.center.x, box.center.y, box.center.z, box.center.w, box.extra.x);
+    halfSize = float[5](box.halfSize.x, box.halfSize.y, box.halfSize.z, box.halfSize.w, box.extra.y);
+}
+
+// Nearest box distance in a cell plus hidden-dimension fog at p
+float sampleCell(vec3 p, uvec2 cell, out uint hitBox, out float fog, out vec3 fogColor)
+{
+    float w[5];
+    for (int i = 0; i < 5; ++i) {
+        w[i] = dot(uSliceRows[i], p);
+    }
+
+    float best = 1e30;
+    hitBox = 0u;
+    fog = 0.0;
+    fogColor = vec3(0.0);
+
+    for (uint k = 0u; k < cell.y; ++k) {
+        uint b = cellBoxes[cell.x + k];
+        float center[5], halfSize[5];
+        loadBox(b, center, halfSize);
+
+        float outsideSq = 0.0;
+        float inside = -1e30;
+        vec3 onSlice = vec3(0.0);
+        for (int i = 0; i < 5; ++i) {
+            float local = w[i] - center[i];
+            float q = abs(local) - halfSize[i];
+            inside = max(inside, q);
+            if (q > 0.0) {
+                outsideSq += q * q;
+                onSlice += uSliceProject[i] * (local < 0.0 ? -q : q);
+            }
+        }
+
+        float outside = sqrt(outsideSq);
+        float dist = outside + min(inside, 0.0);
+        if (dist < best) {
+            best = dist;
+            hitBox = b;
+        }
+
+        if (outside > 0.0) {
+            float sliceDist = length(onSlice);
+            float hiddenDist = sqrt(max(outsideSq - sliceDist * sliceDist, 0.0));
+            float density = exp(-hiddenDist / uFogFalloff)
+                          * clamp(1.0 - sliceDist / uFogEdge, 0.0, 1.0)
+                          * clamp(hiddenDist / uFogEdge, 0.0, 1.0);
+            fog += density;
+            fogColor += boxes[b].colorOpacity.rgb * density;
+        }
+    }
+
+    if (fog > 0.0) {
+        fogColor /= fog;
+    }
+    return best;
+}
+
+vec3 shade(vec3 p, vec3 dir, uint b)
+{
+    float center[5], halfSize[5];
+    loadBox(b, center, halfSize);
+
+    float local[5], q[5];
+    int maxAxis = 0;
+    bool outside = false;
+    for (int i = 0; i < 5; ++i) {
+        local[i] = dot(uSliceRows[i], p) - center[i];
+        q[i] = abs(local[i]) - halfSize[i];
+        if (q[i] > q[maxAxis]) maxAxis = i;
+        if (q[i] > 0.0) outside = true;
+    }
+
+    vec3 normal = vec3(0.0);
+    for (int i = 0; i < 5; ++i) {
+        float g = outside ? max(q[i], 0.0) : (i == maxAxis ? 1.0 : 0.0);
+        normal += uSliceRows[i] * (local[i] < 0.0 ? -g : g);
+    }
+    normal = length(normal) > 1e-6 ? normalize(normal) : -dir;
+
+    float diffuse = max(dot(normal, normalize(uLightPos - p)), 0.0);
+    return boxes[b].colorOpacity.rgb * (0.3 + 0.7 * diffuse);
+}
+
+void main()
+{
+    vec4 farPoint = uInvViewProj * vec4(ScreenUV * 2.0 - 1.0, 1.0, 1.0);
+    vec3 dir = normalize(farPoint.xyz / farPoint.w - uViewPos);
+
+    vec3 fogAccum = vec3(0.0);
+    float fogAlpha = 0.0;
+
+    // Clip the ray to the grid
+    vec3 gridMax = uGridMin + uCellSize * vec3(uGridDims);
+    vec3 invDir = 1.0 / dir;
+    vec3 t0 = (uGridMin - uViewPos) * invDir;
+    vec3 t1 = (gridMax - uViewPos) * invDir;
+    vec3 tNear = min(t0, t1);
+    vec3 tFar = max(t0, t1);
+    float tEnter = max(max(tNear.x, tNear.y), max(tNear.z, 0.0));
+    float tExit = min(min(tFar.x, tFar.y), tFar.z);
+
+    if (uGridDims.x == 0 || tEnter >= tExit) {
+        FragColor = vec4(uBackground, 1.0);
+        return;
+    }
+
+    // 3D DDA setup
+    vec3 start = uViewPos + dir * tEnter;
+    ivec3 cell = clamp(ivec3((start - uGridMin) / uCellSize), ivec3(0), uGridDims - 1);
+    ivec3 stepDir = ivec3(sign(dir));
+    vec3 nextBoundary = uGridMin + (vec3(cell) + max(vec3(stepDir), 0.0)) * uCellSize;
+    vec3 tMax = mix(vec3(1e30), (nextBoundary - uViewPos) * invDir, notEqual(stepDir, ivec3(0)));
+    vec3 tDelta = mix(vec3(1e30), abs(uCellSize * invDir), notEqual(stepDir, ivec3(0)));
+
+    float t = tEnter;
+    int steps = 0;
+    while (steps < uMaxSteps && t < tExit) {
+        float cellExit = min(min(tMax.x, tMax.y), min(tMax.z, tExit));
+        uvec2 cellRange = cells[(cell.z * uGridDims.y + cell.y) * uGridDims.x + cell.x];
+
+        // Sphere-trace without leaving the cell
+        while (cellRange.y > 0u && t < cellExit && steps < uMaxSteps) {
+            ++steps;
+            vec3 p = uViewPos + dir * t;
+            uint hitBox;
+            float fog;
+            vec3 fogColor;
+            float dist = sampleCell(p, cellRange, hitBox, fog, fogColor);
+
+            if (dist < uHitEpsilon) {
+                vec3 surface = mix(uBackground, shade(p, dir, hitBox), boxes[hitBox].colorOpacity.a);
+                FragColor = vec4(fogAccum + surface * (1.0 - fogAlpha), 1.0);
+                return;
+            }
+
+            float advance = max(dist, uHitEpsilon);
+            if (fog > 1e-3) {
+                advance = min(advance, uFogStep);
+                float a = 1.0 - exp(-fog * uFogDensity * advance);
+                fogAccum += fogColor * (a * (1.0 - fogAlpha));
+                fogAlpha += a * (1.0 - fogAlpha);
+            }
+
+            if (t + advance >= cellExit) break;
+            t += advance;
+        }
+
+        t = cellExit;
+
+        int axis = (tMax.x < tMax.y) ? ((tMax.x < tMax.z) ? 0 : 2) : ((tMax.y < tMax.z) ? 1 : 2);
+        cell[axis] += stepDir[axis];
+        if (cell[axis] < 0 || cell[axis] >= uGridDims[axis]) break;
+        tMax[axis] += tDelta[axis];
+    }
+
+    FragColor = vec4(fogAccum + uBackground * (1.0 - fogAlpha), 1.0);
+}
@@ -7,13 +7,28 @@ uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
 
+uniform vec3 uColor;
+uniform float uOpacity;
+uniform vec3 uHiddenDimTint;
+
 out vec3 FragPos;
 out vec3 Normal;
+out float ViewDepth;
+out vec3 ObjectColor;
+out float ObjectOpacity;
+out vec3 ObjectTint;
 
 void main()
 {
     FragPos = vec3(uModel * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(uModel))) * aNormal;
     
-    gl_Position = uProjection * uView * vec4(FragPos, 1.0);
+    vec4 viewPos = uView * vec4(FragPos, 1.0);
+    ViewDepth = -viewPos.z;
+    
+    ObjectColor = uColor;
+    ObjectOpacity = uOpacity;
+    ObjectTint = uHiddenDimTint;
+    
+    gl_Position = uProjection * viewPos;
 }
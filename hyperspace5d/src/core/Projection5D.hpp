@@ -4,7 +4,7 @@
 #include "Matrix5D.hpp"
 #include "DimensionState.hpp"
 #include <glm/glm.hpp>
-#include <vector>
+#include <span>
 
 /**
  * Projection5D - Handles projection from 5D space to 3D viewable space
@@ -62,20 +62,17 @@ public:
     }
 
     /**
-     * Project multiple 5D points at once.
+     * Project multiple 5D points at once into out, which must hold at least
+     * as many points. Allocates nothing.
      */
-    std::vector<glm::vec3> projectBatch(
-        const std::vector<Vec5D>& points5D, 
-        const DimensionState& dimState
+    void projectBatch(
+        std::span<const Vec5D> points5D, 
+        const DimensionState& dimState,
+        std::span<glm::vec3> out
     ) const {
-        std::vector<glm::vec3> result;
-        result.reserve(points5D.size());
-        
-        for (const auto& pt : points5D) {
-            result.push_back(project(pt, dimState));
+        for (size_t i = 0; i < points5D.size(); ++i) {
+            out[i] = project(points5D[i], dimState);
         }
-        
-        return result;
     }
 
     /**
@@ -136,6 +133,22 @@ public:
         return glm::clamp(tint, glm::vec3(0.5f), glm::vec3(1.5f));
     }
 
+    /**
+     * Radius of the 3D cross-section of a 5D sphere with the visible slice.
+     * 
+     * A sphere of radius r whose center sits at hidden depth h meets the
+     * slice in a 3D sphere of radius sqrt(r^2 - h^2). Used for light falloff
+     * so lights deep in hidden dimensions fade out instead of popping.
+     * 
+     * @return Slice radius, or 0 if the sphere doesn't reach the slice
+     */
+    float sliceRadius(const Vec5D& center, float radius, const DimensionState& dimState) const {
+        float hiddenDepth = getHiddenDepth(center, dimState);
+        float r2 = radius * radius - hiddenDepth * hiddenDepth;
+        if (r2 <= 0.0f) return 0.0f;
+        return std::sqrt(r2) * calculateScale(center, dimState);
+    }
+
     /**
      * Check if a 5D point is "visible" (close enough in hidden dimensions).
      * Objects too far in hidden dimensions might be culled.
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Vec5D.hpp"
+#include "Matrix5D.hpp"
+#include <cmath>
+#include <utility>
+
+/**
+ * Transform5D - Affine transformation in 5D space
+ *
+ * The 6x6 homogeneous matrix
+ *
+ *     | L  t |
+ *     | 0  1 |
+ *
+ * with L a Matrix5D (rotation, scale) and t a translation. The bottom row
+ * never changes, so only L and t are stored, and composing or inverting
+ * works on the 5x5 block instead of the full 6x6 matrix.
+ */
+class Transform5D {
+public:
+    Matrix5D linear;
+    Vec5D translation;
+
+    // Constructors
+    Transform5D() : linear(), translation() {}
+
+    Transform5D(const Matrix5D& l, const Vec5D& t) : linear(l), translation(t) {}
+
+    static Transform5D translate(const Vec5D& offset) {
+        return Transform5D(Matrix5D(), offset);
+    }
+
+    static Transform5D rotate(int axis1, int axis2, float angle) {
+        return Transform5D(Matrix5D::rotation(axis1, axis2, angle), Vec5D());
+    }
+
+    static Transform5D scale(const Vec5D& factors) {
+        Matrix5D mat;
+        for (int i = 0; i < 5; ++i) {
+            mat.m[i][i] = factors[i];
+        }
+        return Transform5D(mat, Vec5D());
+    }
+
+    // Apply to a point (translation included) or a direction (not)
+    Vec5D transformPoint(const Vec5D& point) const {
+        return linear * point + translation;
+    }
+
+    Vec5D transformVector(const Vec5D& vec) const {
+        return linear * vec;
+    }
+
+    /**
+     * Size of the axis-aligned box around a box of the given size after
+     * this transform. Objects stay axis-aligned, so a rotated object
+     * grows to cover its rotated extent.
+     */
+    Vec5D transformExtent(const Vec5D& size) const {
+        Vec5D result;
+        for (int row = 0; row < 5; ++row) {
+            result[row] = 0;
+            for (int col = 0; col < 5; ++col) {
+                result[row] += std::fabs(linear.m[col][row]) * size[col];
+            }
+        }
+        return result;
+    }
+
+    // Composition: (a * b) applies b first, then a
+    Transform5D operator*(const Transform5D& other) const {
+        return Transform5D(linear * other.linear, linear * other.translation + translation);
+    }
+
+    /**
+     * Inverse of a rigid transform (rotations and translation only): the
+     * rotation's inverse is its transpose, so no elimination is needed.
+     */
+    Transform5D inverseRigid() const {
+        Matrix5D rotation = linear.transpose();
+        return Transform5D(rotation, Vec5D() - rotation * translation);
+    }
+
+    /**
+     * Inverse of any affine transform, by Gauss-Jordan elimination on the
+     * linear part. Returns false, leaving out unchanged, if the transform
+     * is singular (e.g. scaled to zero along an axis).
+     */
+    bool inverse(Transform5D& out) const {
+        Matrix5D a = linear;
+        Matrix5D inv;
+        for (int col = 0; col < 5; ++col) {
+            // Partial pivoting: largest remaining entry in this column
+            int pivot = col;
+            for (int row = col + 1; row < 5; ++row) {
+                if (std::fabs(a.m[col][row]) > std::fabs(a.m[col][pivot])) pivot = row;
+            }
+            if (std::fabs(a.m[col][pivot]) < 1e-8f) return false;
+            if (pivot != col) {
+                for (int k = 0; k < 5; ++k) {
+                    std::swap(a.m[k][col], a.m[k][pivot]);
+                    std::swap(inv.m[k][col], inv.m[k][pivot]);
+                }
+            }
+
+            float scale = 1.0f / a.m[col][col];
+            for (int k = 0; k < 5; ++k) {
+                a.m[k][col] *= scale;
+                inv.m[k][col] *= scale;
+            }
+            for (int row = 0; row < 5; ++row) {
+                if (row == col) continue;
+                float factor = a.m[col][row];
+                if (factor == 0.0f) continue;
+                for (int k = 0; k < 5; ++k) {
+                    a.m[k][row] -= factor * a.m[k][col];
+                    inv.m[k][row] -= factor * inv.m[k][col];
+                }
+            }
+        }
+        out = Transform5D(inv, Vec5D() - inv * translation);
+        return true;
+    }
+
+    // Element of the full 6x6 matrix, column-major like Matrix5D
+    float at(int col, int row) const {
+        if (row == 5) return col == 5 ? 1.0f : 0.0f;
+        if (col == 5) return translation[row];
+        return linear.m[col][row];
+    }
+};
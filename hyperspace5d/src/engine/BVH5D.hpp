@@ -0,0 +1,489 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include "RayBatch5D.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * BVH5D - Bounding volume hierarchy over static 5D boxes
+ *
+ * Built top-down with a binned surface area heuristic. The 5D version of
+ * surface area is the total measure of a box's eight 4D faces, i.e. the sum
+ * over each axis of the product of the other four extents; it is
+ * proportional to the chance that a random ray or box hits the node.
+ *
+ * Nodes are stored depth-first in one array: a node's left child is the
+ * next node and only the right child's index is kept. Leaves reference a
+ * contiguous run of the primitive array.
+ *
+ * Meant for geometry that never moves. Adding or removing a static object
+ * needs a rebuild, which is cheap at level sizes.
+ */
+class BVH5D {
+public:
+    struct Node {
+        Vec5D boundsMin;
+        Vec5D boundsMax;
+        int rightOrFirst;       // Internal: right child index. Leaf: first primitive
+        int count;              // Primitives in a leaf, 0 for internal nodes
+
+        bool isLeaf() const {
+            return count > 0;
+        }
+    };
+
+    std::vector<Node> nodes;
+    std::vector<GameObject5D*> primitives;
+    int maxLeafSize;            // Always split above this many primitives
+
+    BVH5D()
+        : maxLeafSize(4)
+    {}
+
+    void clear() {
+        nodes.clear();
+        primitives.clear();
+    }
+
+    bool empty() const {
+        return nodes.empty();
+    }
+
+    int getNodeCount() const {
+        return static_cast<int>(nodes.size());
+    }
+
+    int getPrimitiveCount() const {
+        return static_cast<int>(primitives.size());
+    }
+
+    /**
+     * Build the tree from scratch.
+     */
+    void build(const std::vector<GameObject5D*>& objects) {
+        clear();
+        if (objects.empty()) return;
+
+        primitives = objects;
+        primBounds.resize(objects.size());
+        for (size_t i = 0; i < objects.size(); ++i) {
+            Box& box = primBounds[i];
+            objects[i]->getBounds(box.min, box.max);
+            box.centroid = (box.min + box.max) * 0.5f;
+        }
+
+        std::vector<int> order(objects.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+
+        nodes.reserve(objects.size() * 2);
+        buildNode(order, 0, static_cast<int>(order.size()), 0);
+
+        // Put primitives in leaf order
+        std::vector<GameObject5D*> sorted(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            sorted[i] = objects[order[i]];
+        }
+        primitives.swap(sorted);
+        primBounds.clear();
+    }
+
+    /**
+     * Call fn for every primitive whose bounds overlap the box.
+     */
+    template<typename Fn>
+    void queryBox(const Vec5D& boxMin, const Vec5D& boxMax, Fn&& fn) const {
+        if (nodes.empty()) return;
+
+        int stack[StackSize];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!overlapsBox(node, boxMin, boxMax)) continue;
+
+            if (node.isLeaf()) {
+                for (int i = 0; i < node.count; ++i) {
+                    fn(primitives[node.rightOrFirst + i]);
+                }
+            } else {
+                int self = static_cast<int>(&node - nodes.data());
+                stack[top++] = node.rightOrFirst;
+                stack[top++] = self + 1;
+            }
+        }
+    }
+
+    /**
+     * Call fn for every primitive whose bounds contain the point.
+     */
+    template<typename Fn>
+    void queryPoint(const Vec5D& point, Fn&& fn) const {
+        queryBox(point, point, fn);
+    }
+
+    /**
+     * Nearest hit along a ray, testing each box of multi-box objects.
+     * Only solid objects are hit. Returns false if nothing is closer than
+     * maxDistance.
+     */
+    bool rayCast(const Vec5D& origin, const Vec5D& direction, float maxDistance,
+                 GameObject5D** hitObject, float* hitDistance) const {
+        if (nodes.empty()) return false;
+
+        float closest = maxDistance;
+        GameObject5D* closestObject = nullptr;
+
+        struct Entry {
+            int node;
+            float t;
+        };
+        Entry stack[StackSize];
+        int top = 0;
+
+        float tRoot;
+        if (!rayHitsBox(origin, direction, nodes[0].boundsMin, nodes[0].boundsMax, closest, &tRoot)) {
+            return false;
+        }
+        stack[top++] = {0, tRoot};
+
+        while (top > 0) {
+            Entry entry = stack[--top];
+            if (entry.t > closest) continue;
+            const Node& node = nodes[entry.node];
+
+            if (node.isLeaf()) {
+                for (int i = 0; i < node.count; ++i) {
+                    GameObject5D* obj = primitives[node.rightOrFirst + i];
+                    if (!obj->isSolid) continue;
+
+                    for (int instance = 0; instance < obj->instanceCount(); ++instance) {
+                        Vec5D center = obj->instancePosition(instance);
+                        Vec5D objMin = center - obj->size() * 0.5f;
+                        Vec5D objMax = center + obj->size() * 0.5f;
+                        float t;
+                        if (rayHitsBox(origin, direction, objMin, objMax, closest, &t) && t < closest) {
+                            closest = t;
+                            closestObject = obj;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            // Push the farther child first so the nearer one is visited next
+            int left = entry.node + 1;
+            int right = node.rightOrFirst;
+            float tLeft, tRight;
+            bool hitLeft = rayHitsBox(origin, direction, nodes[left].boundsMin, nodes[left].boundsMax, closest, &tLeft);
+            bool hitRight = rayHitsBox(origin, direction, nodes[right].boundsMin, nodes[right].boundsMax, closest, &tRight);
+            if (hitLeft && hitRight) {
+                if (tLeft < tRight) {
+                    stack[top++] = {right, tRight};
+                    stack[top++] = {left, tLeft};
+                } else {
+                    stack[top++] = {left, tLeft};
+                    stack[top++] = {right, tRight};
+                }
+            } else if (hitLeft) {
+                stack[top++] = {left, tLeft};
+            } else if (hitRight) {
+                stack[top++] = {right, tRight};
+            }
+        }
+
+        if (!closestObject) return false;
+        if (hitObject) *hitObject = closestObject;
+        if (hitDistance) *hitDistance = closest;
+        return true;
+    }
+
+    /**
+     * Nearest hit for every live lane of a packet. The packet walks the
+     * tree together: a node is visited if any lane can still hit it, and
+     * each box is tested against all lanes at once.
+     */
+    void rayCastPacket(RayPacket5D& packet) const {
+        if (nodes.empty()) return;
+
+        float tEntry[RayBatch5D::Lanes];
+        float tRight[RayBatch5D::Lanes];
+        int stack[StackSize];
+        int top = 0;
+        if (packet.intersect(nodes[0].boundsMin, nodes[0].boundsMax, tEntry)) {
+            stack[top++] = 0;
+        }
+
+        while (top > 0) {
+            int index = stack[--top];
+            const Node& node = nodes[index];
+
+            if (!node.isLeaf()) {
+                // Test both children here and visit the one the packet
+                // reaches first, so hits found there cull the other
+                int left = index + 1;
+                int right = node.rightOrFirst;
+                unsigned leftMask = packet.intersect(nodes[left].boundsMin, nodes[left].boundsMax, tEntry);
+                unsigned rightMask = packet.intersect(nodes[right].boundsMin, nodes[right].boundsMax, tRight);
+                if (leftMask && rightMask) {
+                    if (firstEntry(tEntry, leftMask) <= firstEntry(tRight, rightMask)) {
+                        stack[top++] = right;
+                        stack[top++] = left;
+                    } else {
+                        stack[top++] = left;
+                        stack[top++] = right;
+                    }
+                } else if (leftMask) {
+                    stack[top++] = left;
+                } else if (rightMask) {
+                    stack[top++] = right;
+                }
+                continue;
+            }
+
+            for (int i = 0; i < node.count; ++i) {
+                GameObject5D* obj = primitives[node.rightOrFirst + i];
+                if (!obj->isSolid) continue;
+
+                for (int instance = 0; instance < obj->instanceCount(); ++instance) {
+                    Vec5D center = obj->instancePosition(instance);
+                    unsigned mask = packet.intersect(center - obj->size() * 0.5f, center + obj->size() * 0.5f, tEntry);
+                    for (int k = 0; k < RayBatch5D::Lanes; ++k) {
+                        bool nearer = ((mask >> k) & 1u) && tEntry[k] < packet.closest[k];
+                        packet.closest[k] = nearer ? tEntry[k] : packet.closest[k];
+                        packet.hitObject[k] = nearer ? obj : packet.hitObject[k];
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Slab test of a ray against a box over [0, maxDistance]. A ray parallel
+     * to a slab only hits if it starts inside it.
+     */
+    static bool rayHitsBox(const Vec5D& origin, const Vec5D& direction,
+                           const Vec5D& boxMin, const Vec5D& boxMax,
+                           float maxDistance, float* tEntry) {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+
+        for (int i = 0; i < 5; ++i) {
+            if (std::abs(direction[i]) > 1e-6f) {
+                float invDir = 1.0f / direction[i];
+                float t1 = (boxMin[i] - origin[i]) * invDir;
+                float t2 = (boxMax[i] - origin[i]) * invDir;
+                tMin = std::max(tMin, std::min(t1, t2));
+                tMax = std::min(tMax, std::max(t1, t2));
+                if (tMin > tMax) return false;
+            } else if (origin[i] < boxMin[i] || origin[i] > boxMax[i]) {
+                return false;
+            }
+        }
+
+        *tEntry = tMin;
+        return true;
+    }
+
+private:
+    static constexpr int BinCount = 12;
+    static constexpr int StackSize = 64;
+
+    struct Box {
+        Vec5D min;
+        Vec5D max;
+        Vec5D centroid;
+    };
+
+    struct Bin {
+        Vec5D min;
+        Vec5D max;
+        int count;
+    };
+
+    std::vector<Box> primBounds;    // Only valid during build
+
+    /**
+     * Earliest entry distance among the lanes in a mask
+     */
+    static float firstEntry(const float* tEntry, unsigned mask) {
+        float first = std::numeric_limits<float>::max();
+        for (int k = 0; k < RayBatch5D::Lanes; ++k) {
+            if ((mask >> k) & 1u) first = std::min(first, tEntry[k]);
+        }
+        return first;
+    }
+
+    static float boundaryMeasure(const Vec5D& boxMin, const Vec5D& boxMax) {
+        float extent[5];
+        for (int i = 0; i < 5; ++i) {
+            extent[i] = std::max(boxMax[i] - boxMin[i], 0.0f);
+        }
+
+        float measure = 0.0f;
+        for (int skip = 0; skip < 5; ++skip) {
+            float face = 1.0f;
+            for (int i = 0; i < 5; ++i) {
+                if (i != skip) face *= extent[i];
+            }
+            measure += face;
+        }
+        return measure;
+    }
+
+    static void growBox(Vec5D& boxMin, Vec5D& boxMax, const Vec5D& otherMin, const Vec5D& otherMax) {
+        for (int i = 0; i < 5; ++i) {
+            boxMin[i] = std::min(boxMin[i], otherMin[i]);
+            boxMax[i] = std::max(boxMax[i], otherMax[i]);
+        }
+    }
+
+    static void emptyBox(Vec5D& boxMin, Vec5D& boxMax) {
+        const float big = std::numeric_limits<float>::max();
+        boxMin = Vec5D(big, big, big, big, big);
+        boxMax = Vec5D(-big, -big, -big, -big, -big);
+    }
+
+    static bool overlapsBox(const Node& node, const Vec5D& boxMin, const Vec5D& boxMax) {
+        for (int i = 0; i < 5; ++i) {
+            if (node.boundsMax[i] < boxMin[i] || node.boundsMin[i] > boxMax[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int buildNode(std::vector<int>& order, int start, int end, int depth) {
+        int index = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+
+        Vec5D boundsMin, boundsMax, centroidMin, centroidMax;
+        emptyBox(boundsMin, boundsMax);
+        emptyBox(centroidMin, centroidMax);
+        for (int i = start; i < end; ++i) {
+            const Box& box = primBounds[order[i]];
+            growBox(boundsMin, boundsMax, box.min, box.max);
+            growBox(centroidMin, centroidMax, box.centroid, box.centroid);
+        }
+        nodes[index].boundsMin = boundsMin;
+        nodes[index].boundsMax = boundsMax;
+
+        int count = end - start;
+        int splitAxis = -1;
+        int splitBin = 0;
+        if (count > 1) {
+            findSplit(order, start, end, centroidMin, centroidMax,
+                      boundaryMeasure(boundsMin, boundsMax), splitAxis, splitBin);
+        }
+
+        // Queries keep one stack entry per level
+        bool tooDeep = depth >= StackSize - 2;
+        if (count == 1 || tooDeep || (splitAxis < 0 && count <= maxLeafSize)) {
+            nodes[index].rightOrFirst = start;
+            nodes[index].count = count;
+            return index;
+        }
+
+        // Partition by bin, falling back to a median split on the widest
+        // axis if SAH found nothing or the bins ended up one-sided
+        int mid = start;
+        if (splitAxis >= 0) {
+            float axisMin = centroidMin[splitAxis];
+            float scale = BinCount / (centroidMax[splitAxis] - axisMin);
+            auto middle = std::partition(order.begin() + start, order.begin() + end, [&](int prim) {
+                return binIndex(primBounds[prim].centroid[splitAxis], axisMin, scale) <= splitBin;
+            });
+            mid = static_cast<int>(middle - order.begin());
+        } else {
+            splitAxis = 0;
+            for (int i = 1; i < 5; ++i) {
+                if (centroidMax[i] - centroidMin[i] > centroidMax[splitAxis] - centroidMin[splitAxis]) {
+                    splitAxis = i;
+                }
+            }
+        }
+        if (mid == start || mid == end) {
+            mid = start + count / 2;
+            std::nth_element(order.begin() + start, order.begin() + mid, order.begin() + end, [&](int a, int b) {
+                return primBounds[a].centroid[splitAxis] < primBounds[b].centroid[splitAxis];
+            });
+        }
+
+        nodes[index].count = 0;
+        buildNode(order, start, mid, depth + 1);
+        int right = buildNode(order, mid, end, depth + 1);
+        nodes[index].rightOrFirst = right;
+        return index;
+    }
+
+    static int binIndex(float value, float axisMin, float scale) {
+        return std::min(static_cast<int>((value - axisMin) * scale), BinCount - 1);
+    }
+
+    /**
+     * Pick the binned split with the lowest SAH cost. Leaves splitAxis at -1
+     * if keeping the primitives in one leaf is cheaper or no split exists.
+     */
+    void findSplit(const std::vector<int>& order, int start, int end,
+                   const Vec5D& centroidMin, const Vec5D& centroidMax, float parentMeasure,
+                   int& splitAxis, int& splitBin) const {
+        int count = end - start;
+        float bestCost = std::numeric_limits<float>::max();
+
+        for (int axis = 0; axis < 5; ++axis) {
+            float extent = centroidMax[axis] - centroidMin[axis];
+            if (extent < 1e-6f) continue;
+
+            Bin bins[BinCount];
+            for (Bin& bin : bins) {
+                emptyBox(bin.min, bin.max);
+                bin.count = 0;
+            }
+            float scale = BinCount / extent;
+            for (int i = start; i < end; ++i) {
+                const Box& box = primBounds[order[i]];
+                Bin& bin = bins[binIndex(box.centroid[axis], centroidMin[axis], scale)];
+                growBox(bin.min, bin.max, box.min, box.max);
+                ++bin.count;
+            }
+
+            // Sweep from the right to get the cost of everything above each plane
+            float rightMeasure[BinCount];
+            int rightCount[BinCount];
+            Vec5D sweepMin, sweepMax;
+            emptyBox(sweepMin, sweepMax);
+            int sweepCount = 0;
+            for (int b = BinCount - 1; b > 0; --b) {
+                growBox(sweepMin, sweepMax, bins[b].min, bins[b].max);
+                sweepCount += bins[b].count;
+                rightMeasure[b] = sweepCount > 0 ? boundaryMeasure(sweepMin, sweepMax) : 0.0f;
+                rightCount[b] = sweepCount;
+            }
+
+            emptyBox(sweepMin, sweepMax);
+            sweepCount = 0;
+            for (int b = 0; b < BinCount - 1; ++b) {
+                growBox(sweepMin, sweepMax, bins[b].min, bins[b].max);
+                sweepCount += bins[b].count;
+                if (sweepCount == 0 || rightCount[b + 1] == 0) continue;
+
+                float cost = boundaryMeasure(sweepMin, sweepMax) * sweepCount
+                           + rightMeasure[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    splitAxis = axis;
+                    splitBin = b;
+                }
+            }
+        }
+
+        // One traversal step costs about as much as one box test
+        float leafCost = parentMeasure * count;
+        float splitCost = parentMeasure + bestCost;
+        if (splitCost >= leafCost) {
+            splitAxis = -1;
+        }
+    }
+};
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+#include "../core/Projection5D.hpp"
+#include "GameObject5D.hpp"
+#include "EntityStore5D.hpp"
+
+/**
+ * ClusteredLighting - Clustered forward shading for 5D point lights
+ *
+ * Glowing objects (goals, boss cores, projectiles) emit lights that live in
+ * 5D. Each frame the lights are cut down to the visible 3D slice through
+ * Projection5D, then binned into a froxel grid: screen tiles in X/Y and
+ * exponentially spaced slices in view depth. The fragment shader looks up
+ * the cluster it falls into and only shades the lights listed there.
+ *
+ * GPU layout (std430 shader storage buffers):
+ *   binding 0: lights   - vec4 position/radius, vec4 color/intensity
+ *   binding 1: clusters - uvec2 offset/count into the index list
+ *   binding 2: indices  - uint light index per cluster entry
+ */
+class ClusteredLighting {
+public:
+    static constexpr int TilesX = 16;
+    static constexpr int TilesY = 9;
+    static constexpr int Slices = 24;
+    static constexpr int ClusterCount = TilesX * TilesY * Slices;
+    static constexpr int MaxLights = 256;
+    static constexpr int MaxLightIndices = ClusterCount * 32;
+
+    struct GpuLight {
+        glm::vec4 positionRadius;   // World-space 3D position, slice radius
+        glm::vec4 colorIntensity;
+    };
+
+    // Depth range covered by the slices; anything nearer lands in slice 0
+    float clusterNear;
+    float clusterFar;
+
+    std::vector<GpuLight> lights;
+    std::vector<uint32_t> clusters;       // offset, count pairs
+    std::vector<uint32_t> lightIndices;
+
+    int indexOverflow;                    // Entries dropped last frame
+
+    ClusteredLighting()
+        : clusterNear(1.0f)
+        , clusterFar(100.0f)
+        , indexOverflow(0)
+        , lightSSBO(0)
+        , clusterSSBO(0)
+        , indexSSBO(0)
+    {
+        lights.reserve(MaxLights);
+        clusters.resize(ClusterCount * 2);
+        lightIndices.reserve(MaxLightIndices);
+        lightRanges.reserve(MaxLights);
+        clusterCounts.resize(ClusterCount);
+    }
+
+    ~ClusteredLighting() {
+        if (lightSSBO) glDeleteBuffers(1, &lightSSBO);
+        if (clusterSSBO) glDeleteBuffers(1, &clusterSSBO);
+        if (indexSSBO) glDeleteBuffers(1, &indexSSBO);
+    }
+
+    void create() {
+        glGenBuffers(1, &lightSSBO);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, MaxLights * sizeof(GpuLight), NULL, GL_DYNAMIC_DRAW);
+
+        glGenBuffers(1, &clusterSSBO);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, ClusterCount * 2 * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+
+        glGenBuffers(1, &indexSSBO);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, MaxLightIndices * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    /**
+     * Gather light-emitting entity table rows (from the body columns) and
+     * objects, and cut them down to the current slice. Lights too deep in
+     * hidden dimensions to reach the slice are dropped.
+     */
+    void collectLights(const EntityStore5D& entities, std::span<GameObject5D* const> objects,
+                       const Projection5D& projection,
+                       const DimensionState& dimState) {
+        lights.clear();
+
+        entities.forEachTable([&](const EntityTable5D& table) {
+            for (int row = 0; row < table.rowCount(); ++row) {
+                if (!table.visible[row] || table.lightIntensity[row] <= 0.0f) continue;
+                addLight(table.position[row], table.color[row], table.lightIntensity[row] * table.opacity[row],
+                         table.lightRadius[row], projection, dimState);
+            }
+        });
+
+        for (const auto& obj : objects) {
+            if (!obj->isVisible() || obj->lightIntensity() <= 0.0f) continue;
+            addLight(obj->position(), obj->color(), obj->lightIntensity() * obj->opacity(),
+                     obj->lightRadius(), projection, dimState);
+        }
+    }
+
+    /**
+     * Bin the collected lights into clusters for the given camera.
+     */
+    void buildClusters(const glm::mat4& view, const glm::mat4& proj) {
+        lightRanges.clear();
+        std::fill(clusterCounts.begin(), clusterCounts.end(), 0u);
+
+        // Pass 1: find the cluster range each light touches and count
+        for (uint32_t i = 0; i < lights.size(); ++i) {
+            LightRange range;
+            if (!computeRange(lights[i], view, proj, range)) continue;
+            range.light = i;
+            lightRanges.push_back(range);
+
+            for (int z = range.z0; z <= range.z1; ++z)
+                for (int y = range.y0; y <= range.y1; ++y)
+                    for (int x = range.x0; x <= range.x1; ++x)
+                        ++clusterCounts[clusterIndex(x, y, z)];
+        }
+
+        // Prefix sum into offsets, clamped to the index budget
+        uint32_t offset = 0;
+        indexOverflow = 0;
+        for (int c = 0; c < ClusterCount; ++c) {
+            uint32_t count = clusterCounts[c];
+            if (offset + count > static_cast<uint32_t>(MaxLightIndices)) {
+                indexOverflow += static_cast<int>(offset + count) - MaxLightIndices;
+                count = static_cast<uint32_t>(MaxLightIndices) - offset;
+            }
+            clusters[c * 2] = offset;
+            clusters[c * 2 + 1] = 0;
+            clusterCounts[c] = count;   // Capacity for pass 2
+            offset += count;
+        }
+
+        // Pass 2: scatter light indices
+        lightIndices.resize(offset);
+        for (const LightRange& range : lightRanges) {
+            for (int z = range.z0; z <= range.z1; ++z)
+                for (int y = range.y0; y <= range.y1; ++y)
+                    for (int x = range.x0; x <= range.x1; ++x) {
+                        int c = clusterIndex(x, y, z);
+                        uint32_t& filled = clusters[c * 2 + 1];
+                        if (filled < clusterCounts[c]) {
+                            lightIndices[clusters[c * 2] + filled] = range.light;
+                            ++filled;
+                        }
+                    }
+        }
+    }
+
+    /**
+     * Upload this frame's data and bind the buffers for the shader.
+     */
+    void upload() const {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightSSBO);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, lights.size() * sizeof(GpuLight), lights.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterSSBO);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, clusters.size() * sizeof(uint32_t), clusters.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, indexSSBO);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, lightIndices.size() * sizeof(uint32_t), lightIndices.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, lightSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, clusterSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, indexSSBO);
+    }
+
+    /**
+     * Depth slice for a positive view-space depth (matches the shader).
+     */
+    int depthSlice(float viewDepth) const {
+        if (viewDepth <= clusterNear) return 0;
+        float t = std::log(viewDepth / clusterNear) / std::log(clusterFar / clusterNear);
+        return std::clamp(static_cast<int>(t * Slices), 0, Slices - 1);
+    }
+
+private:
+    struct LightRange {
+        uint32_t light;
+        int x0, x1, y0, y1, z0, z1;
+    };
+
+    GLuint lightSSBO, clusterSSBO, indexSSBO;
+    std::vector<LightRange> lightRanges;
+    std::vector<uint32_t> clusterCounts;
+
+    void addLight(const Vec5D& position, const glm::vec3& color, float intensity, float lightRadius,
+                  const Projection5D& projection, const DimensionState& dimState) {
+        if (static_cast<int>(lights.size()) >= MaxLights) return;
+
+        float radius = projection.sliceRadius(position, lightRadius, dimState);
+        if (radius <= 0.0f) return;
+
+        GpuLight light;
+        light.positionRadius = glm::vec4(projection.project(position, dimState), radius);
+        light.colorIntensity = glm::vec4(color, intensity);
+        lights.push_back(light);
+    }
+
+    static int clusterIndex(int x, int y, int z) {
+        return (z * TilesY + y) * TilesX + x;
+    }
+
+    /**
+     * Conservative froxel range covered by a light's bounding sphere.
+     */
+    bool computeRange(const GpuLight& light, const glm::mat4& view, const glm::mat4& proj,
+                      LightRange& range) const {
+        glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(light.positionRadius), 1.0f));
+        float radius = light.positionRadius.w;
+
+        // View space looks down -Z
+        float nearDepth = -center.z - radius;
+        float farDepth = -center.z + radius;
+        if (farDepth <= 0.0f || nearDepth >= clusterFar) return false;
+
+        range.z0 = depthSlice(nearDepth);
+        range.z1 = depthSlice(farDepth);
+
+        if (nearDepth <= 0.1f) {
+            // Sphere straddles the camera: can't project, cover the screen
+            range.x0 = 0; range.x1 = TilesX - 1;
+            range.y0 = 0; range.y1 = TilesY - 1;
+            return true;
+        }
+
+        // Project the corners of the sphere's view-space box to NDC
+        glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 p = center + glm::vec3(
+                (corner & 1) ? radius : -radius,
+                (corner & 2) ? radius : -radius,
+                (corner & 4) ? radius : -radius
+            );
+            glm::vec4 clip = proj * glm::vec4(p, 1.0f);
+            float invW = 1.0f / clip.w;
+            ndcMin.x = std::min(ndcMin.x, clip.x * invW);
+            ndcMin.y = std::min(ndcMin.y, clip.y * invW);
+            ndcMax.x = std::max(ndcMax.x, clip.x * invW);
+            ndcMax.y = std::max(ndcMax.y, clip.y * invW);
+        }
+        if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f) {
+            return false;
+        }
+
+        range.x0 = std::clamp(static_cast<int>((ndcMin.x * 0.5f + 0.5f) * TilesX), 0, TilesX - 1);
+        range.x1 = std::clamp(static_cast<int>((ndcMax.x * 0.5f + 0.5f) * TilesX), 0, TilesX - 1);
+        range.y0 = std::clamp(static_cast<int>((ndcMin.y * 0.5f + 0.5f) * TilesY), 0, TilesY - 1);
+        range.y1 = std::clamp(static_cast<int>((ndcMax.y * 0.5f + 0.5f) * TilesY), 0, TilesY - 1);
+        return true;
+    }
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "Physics5D.hpp"
+#include <unordered_map>
+#include <memory_resource>
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * CollisionPipeline5D - Contacts between every moving body and the world
+ *
+ * Each frame runs three stages:
+ *   broadphase  - candidate pairs: overlapping broadphase proxies, every
+ *                 proxy and transient against the static BVH and the
+ *                 transient hash, and transient pairs from the hash
+ *   narrowphase - an AABB test giving a manifold (normal, penetration,
+ *                 axis) per touching pair of boxes, so a candidate made of
+ *                 several boxes (echo trails) can have more than one;
+ *                 boxes within Physics5D::ContactSlop of each other count
+ *                 as touching
+ *   pair cache  - manifolds persist across frames, keyed by the two object
+ *                 IDs. A pair whose objects haven't moved keeps its manifold
+ *                 without being tested again.
+ *
+ * Callbacks fire per pair when a contact begins, every frame it persists,
+ * and when it ends. They run after the whole frame's pairs are known and
+ * must not add or remove level objects; mark them for removal instead.
+ * The pipeline only reports contacts, it never moves anything.
+ */
+class CollisionPipeline5D {
+public:
+    static constexpr int MaxManifolds = 4;
+
+    struct ContactPair {
+        GameObject5D* a;                    // Lower ID of the two
+        GameObject5D* b;
+        Physics5D::CollisionInfo manifolds[MaxManifolds];  // Normals point from b to a
+        float normalImpulse[MaxManifolds];  // Solver impulse per manifold, kept to warm start the next frame
+        int manifoldCount;
+        Vec5D positionA;                    // Positions at the last narrowphase
+        Vec5D positionB;
+        uint32_t lastFrame;                 // Last frame the broadphase reported the pair
+        bool touching;
+        bool wasTouching;
+
+        bool involves(const GameObject5D* object) const {
+            return a == object || b == object;
+        }
+
+        GameObject5D* other(const GameObject5D* object) const {
+            return a == object ? b : a;
+        }
+    };
+
+    using Callback = std::function<void(ContactPair&)>;
+    Callback onContactBegin;
+    Callback onContactStay;
+    Callback onContactEnd;
+
+    // Work done by the last update (for the debug UI)
+    int lastCandidates;
+    int lastTested;
+    int lastReused;
+    int lastContacts;
+
+    CollisionPipeline5D()
+        : lastCandidates(0)
+        , lastTested(0)
+        , lastReused(0)
+        , lastContacts(0)
+        , pairs(&pairMemory)
+        , frame(0)
+    {}
+
+    void clear() {
+        pairs.clear();
+        lastCandidates = lastTested = lastReused = lastContacts = 0;
+    }
+
+    /**
+     * Find, test and cache this frame's contact pairs, then fire callbacks.
+     */
+    void update(const BVH5D& staticIndex, const SweepAndPrune5D& broadphase,
+                const std::vector<GameObject5D*>& transients, const SpatialHash5D& transientIndex) {
+        ++frame;
+        lastCandidates = lastTested = lastReused = 0;
+
+        auto visit = [&](GameObject5D* a, GameObject5D* b) {
+            visitPair(a, b);
+        };
+
+        // Moving against moving
+        broadphase.forEachPair(visit);
+
+        // Moving against static and transient; sleeping objects keep their pairs
+        for (const SweepAndPrune5D::Proxy& proxy : broadphase.proxies) {
+            if (!proxy.alive || !proxy.object->isAwake) continue;
+            GameObject5D* object = proxy.object;
+            Vec5D boundsMin, boundsMax;
+            getPaddedBounds(*object, boundsMin, boundsMax);
+            staticIndex.queryBox(boundsMin, boundsMax, [&](GameObject5D* other) {
+                visitPair(object, other);
+            });
+            transientIndex.queryBox(boundsMin, boundsMax, [&](GameObject5D* other) {
+                visitPair(object, other);
+            });
+        }
+
+        // Transient against static and transient
+        for (GameObject5D* object : transients) {
+            Vec5D boundsMin, boundsMax;
+            getPaddedBounds(*object, boundsMin, boundsMax);
+            staticIndex.queryBox(boundsMin, boundsMax, [&](GameObject5D* other) {
+                visitPair(object, other);
+            });
+        }
+        transientIndex.forEachPair(visit);
+
+        // Report changes and drop pairs the broadphase no longer sees
+        lastContacts = 0;
+        for (auto it = pairs.begin(); it != pairs.end();) {
+            ContactPair& pair = it->second;
+            if (!pair.a->isAwake && !pair.b->isAwake) {
+                pair.lastFrame = frame;
+            }
+            bool seen = pair.lastFrame == frame;
+            bool touching = seen && pair.touching;
+
+            if (touching) {
+                ++lastContacts;
+                if (!pair.wasTouching) {
+                    if (onContactBegin) onContactBegin(pair);
+                } else if (onContactStay) {
+                    onContactStay(pair);
+                }
+            } else if (pair.wasTouching && onContactEnd) {
+                onContactEnd(pair);
+            }
+            pair.wasTouching = touching;
+
+            if (seen) {
+                ++it;
+            } else {
+                it = pairs.erase(it);
+            }
+        }
+    }
+
+    /**
+     * Forget every pair an object is part of (it's leaving the level).
+     */
+    void removeObject(const GameObject5D* object) {
+        for (auto it = pairs.begin(); it != pairs.end();) {
+            if (it->second.involves(object)) {
+                it = pairs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Visit each pair currently in contact.
+     */
+    template<typename Fn>
+    void forEachContact(Fn&& fn) {
+        for (auto& entry : pairs) {
+            if (entry.second.lastFrame == frame && entry.second.touching) {
+                fn(entry.second);
+            }
+        }
+    }
+
+    int getPairCount() const {
+        return static_cast<int>(pairs.size());
+    }
+
+private:
+    // Pair nodes come from a pool that keeps freed nodes, so pairs that
+    // start and end every frame don't touch the heap
+    std::pmr::unsynchronized_pool_resource pairMemory;
+    std::pmr::unordered_map<uint64_t, ContactPair> pairs;
+    uint32_t frame;
+
+    static void getPaddedBounds(const GameObject5D& object, Vec5D& boundsMin, Vec5D& boundsMax) {
+        Vec5D pad(Physics5D::ContactSlop, Physics5D::ContactSlop, Physics5D::ContactSlop,
+                  Physics5D::ContactSlop, Physics5D::ContactSlop);
+        object.getBounds(boundsMin, boundsMax);
+        boundsMin -= pad;
+        boundsMax += pad;
+    }
+
+    static bool samePosition(const Vec5D& a, const Vec5D& b) {
+        for (int i = 0; i < 5; ++i) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+
+    void visitPair(GameObject5D* a, GameObject5D* b) {
+        if (a == b) return;
+        if (b->id < a->id || (b->id == a->id && b < a)) std::swap(a, b);
+
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(a->id)) << 32) |
+                       static_cast<uint32_t>(b->id);
+        auto [it, inserted] = pairs.try_emplace(key);
+        ContactPair& pair = it->second;
+
+        // Several broadphase stages can report the same pair
+        if (!inserted && pair.lastFrame == frame && pair.a == a && pair.b == b) return;
+        ++lastCandidates;
+
+        // A new pair, or an ID reused by a different object
+        if (inserted || pair.a != a || pair.b != b) {
+            pair.a = a;
+            pair.b = b;
+            pair.manifoldCount = 0;
+            pair.wasTouching = false;
+        } else if (samePosition(pair.positionA, a->position()) && samePosition(pair.positionB, b->position())) {
+            // Neither moved: the cached manifold still holds
+            pair.lastFrame = frame;
+            ++lastReused;
+            return;
+        }
+
+        Physics5D::CollisionInfo previous[MaxManifolds];
+        float previousImpulse[MaxManifolds];
+        int previousCount = pair.manifoldCount;
+        std::copy_n(pair.manifolds, previousCount, previous);
+        std::copy_n(pair.normalImpulse, previousCount, previousImpulse);
+
+        pair.manifoldCount = Physics5D::checkCollision(*a, *b, pair.manifolds, MaxManifolds,
+                                                       Physics5D::ContactSlop);
+        pair.touching = pair.manifoldCount > 0;
+
+        // A cached impulse only carries over while the same boxes touch
+        // along the same normal
+        for (int i = 0; i < pair.manifoldCount; ++i) {
+            Physics5D::CollisionInfo& manifold = pair.manifolds[i];
+            manifold.object = b;
+            pair.normalImpulse[i] = 0.0f;
+            for (int j = 0; j < previousCount; ++j) {
+                if (previous[j].instanceA == manifold.instanceA &&
+                    previous[j].instanceB == manifold.instanceB &&
+                    previous[j].collisionDim == manifold.collisionDim &&
+                    previous[j].normal[manifold.collisionDim] == manifold.normal[manifold.collisionDim]) {
+                    pair.normalImpulse[i] = previousImpulse[j];
+                }
+            }
+        }
+        pair.positionA = a->position();
+        pair.positionB = b->position();
+        pair.lastFrame = frame;
+        ++lastTested;
+    }
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "CollisionPipeline5D.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * ContactSolver5D - Sequential impulse solver over a frame's contacts
+ *
+ * Works on every manifold of every touching pair of solid objects where
+ * at least one side can move (inverseMass > 0); a pair touching with
+ * several boxes (echo trails) is solved as several contacts. Objects with
+ * zero inverse mass (static and scripted ones) push but are never pushed.
+ *
+ * Velocities: each contact accumulates a normal impulse that removes
+ * approach speed along its normal, clamped so contacts only push. The
+ * impulse is kept in the pipeline's pair cache and applied up front the
+ * next frame (warm starting), so a resting contact starts out already
+ * balanced and the loop usually stops after one pass.
+ *
+ * Positions: remaining overlap is projected out along each contact's
+ * cached normal, re-measured from current positions every pass, so
+ * contacts sharing a body settle to the same result in any order.
+ *
+ * Each contact side keeps where its body lives (table columns or the
+ * object's own) and its mass, so the passes work on the bodies without
+ * going back through the objects.
+ */
+class ContactSolver5D {
+public:
+    int maxVelocityIterations;
+    int maxPositionIterations;
+    float tolerance;                // Impulse / overlap below which a pass counts as converged
+
+    // Results of the last solve (for the debug UI)
+    int lastContacts;
+    int lastVelocityIterations;
+    int lastPositionIterations;
+    float lastResidual;             // Largest impulse change in the final velocity pass
+    float lastPenetration;          // Deepest overlap left after the position passes
+
+    ContactSolver5D()
+        : maxVelocityIterations(8)
+        , maxPositionIterations(4)
+        , tolerance(1e-4f)
+        , lastContacts(0)
+        , lastVelocityIterations(0)
+        , lastPositionIterations(0)
+        , lastResidual(0.0f)
+        , lastPenetration(0.0f)
+    {}
+
+    void solve(CollisionPipeline5D& pipeline) {
+        active.clear();
+        pipeline.forEachContact([&](CollisionPipeline5D::ContactPair& pair) {
+            if (!pair.a->isSolid || !pair.b->isSolid) return;
+            if (pair.a->inverseMass + pair.b->inverseMass <= 0.0f) return;
+            for (int i = 0; i < pair.manifoldCount; ++i) {
+                const Physics5D::CollisionInfo& manifold = pair.manifolds[i];
+                active.push_back(Contact{&pair, i, sideOf(*pair.a, manifold.instanceA),
+                                         sideOf(*pair.b, manifold.instanceB)});
+            }
+        });
+        lastContacts = static_cast<int>(active.size());
+        lastVelocityIterations = 0;
+        lastPositionIterations = 0;
+        lastResidual = 0.0f;
+        lastPenetration = 0.0f;
+        if (active.empty()) return;
+
+        // Warm start with last frame's impulses
+        for (const Contact& contact : active) {
+            applyImpulse(contact, contact.impulse());
+        }
+
+        for (int iteration = 0; iteration < maxVelocityIterations; ++iteration) {
+            float residual = 0.0f;
+            for (const Contact& contact : active) {
+                const Side& a = contact.a;
+                const Side& b = contact.b;
+                const Vec5D& normal = contact.manifold().normal;
+
+                float approach = (a.velocity() - b.velocity()).dot(normal);
+                float impulse = -approach / (a.inverseMass + b.inverseMass);
+
+                float previous = contact.impulse();
+                contact.impulse() = std::max(0.0f, previous + impulse);
+                float applied = contact.impulse() - previous;
+                applyImpulse(contact, applied);
+                residual = std::max(residual, std::abs(applied));
+            }
+            lastVelocityIterations = iteration + 1;
+            lastResidual = residual;
+            if (residual < tolerance) break;
+        }
+
+        for (int iteration = 0; iteration < maxPositionIterations; ++iteration) {
+            float deepest = 0.0f;
+            for (const Contact& contact : active) {
+                float depth = penetration(contact);
+                if (depth <= 0.0f) continue;
+                deepest = std::max(deepest, depth);
+
+                const Side& a = contact.a;
+                const Side& b = contact.b;
+                float share = depth / (a.inverseMass + b.inverseMass);
+                a.position() += contact.manifold().normal * (share * a.inverseMass);
+                b.position() -= contact.manifold().normal * (share * b.inverseMass);
+            }
+            lastPositionIterations = iteration + 1;
+            if (deepest < tolerance) break;
+        }
+        for (const Contact& contact : active) {
+            if (contact.a.inverseMass > 0.0f) contact.a.body->updateBounds(contact.a.row);
+            if (contact.b.inverseMass > 0.0f) contact.b.body->updateBounds(contact.b.row);
+        }
+        for (const Contact& contact : active) {
+            lastPenetration = std::max(lastPenetration, penetration(contact));
+        }
+    }
+
+private:
+    // One object of a contact: its body and the box of it that touches
+    struct Side {
+        const BodyColumns5D* body;
+        int row;
+        float inverseMass;
+        Vec5D offset;                   // Touching box's center relative to position
+
+        Vec5D& position() const { return body->position[row]; }
+        Vec5D& velocity() const { return body->velocity[row]; }
+        const Vec5D& size() const { return body->size[row]; }
+    };
+
+    // One manifold of a pair
+    struct Contact {
+        CollisionPipeline5D::ContactPair* pair;
+        int index;
+        Side a;
+        Side b;
+
+        Physics5D::CollisionInfo& manifold() const {
+            return pair->manifolds[index];
+        }
+
+        float& impulse() const {
+            return pair->normalImpulse[index];
+        }
+    };
+
+    std::vector<Contact> active;
+
+    static Side sideOf(const GameObject5D& obj, int instance) {
+        return Side{obj.body, obj.bodyRow, obj.inverseMass, obj.instancePosition(instance) - obj.position()};
+    }
+
+    static void applyImpulse(const Contact& contact, float impulse) {
+        const Vec5D& normal = contact.manifold().normal;
+        contact.a.velocity() += normal * (impulse * contact.a.inverseMass);
+        contact.b.velocity() -= normal * (impulse * contact.b.inverseMass);
+    }
+
+    /**
+     * Current overlap of the contact's two boxes along its cached axis
+     * (negative when apart).
+     */
+    static float penetration(const Contact& contact) {
+        const Physics5D::CollisionInfo& manifold = contact.manifold();
+        const Side& a = contact.a;
+        const Side& b = contact.b;
+        int dim = manifold.collisionDim;
+        Vec5D centerA = a.position() + a.offset;
+        Vec5D centerB = b.position() + b.offset;
+        float separation = (centerA[dim] - centerB[dim]) * manifold.normal[dim];
+        return (a.size()[dim] + b.size()[dim]) * 0.5f - separation;
+    }
+};
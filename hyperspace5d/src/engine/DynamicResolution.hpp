@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * DynamicResolution - Adapts the scene render scale to hold a GPU time budget
+ *
+ * The scene is rendered into an offscreen target whose size is the window
+ * size multiplied by 'scale'. Each frame the measured GPU time of the scene
+ * pass is fed back in; fragment cost grows roughly with pixel count
+ * (scale squared), so the controller solves for the scale that would land
+ * the frame just under the target and moves part of the way there.
+ *
+ * Decreases react quickly to avoid dropped frames, increases are slow and
+ * only happen with clear headroom so the scale doesn't oscillate.
+ */
+class DynamicResolution {
+public:
+    bool enabled;
+    float targetFrameMs;      // GPU budget for the scene pass (8.3 = 120Hz, 16.6 = 60Hz)
+    float headroom;           // Fraction of the budget we aim for
+    float minScale;
+    float maxScale;
+    float scale;              // Current render scale (per axis)
+    float smoothedGpuMs;      // Filtered GPU time of the scene pass
+
+    DynamicResolution()
+        : enabled(true)
+        , targetFrameMs(16.6f)
+        , headroom(0.9f)
+        , minScale(0.5f)
+        , maxScale(1.0f)
+        , scale(1.0f)
+        , smoothedGpuMs(0.0f)
+    {}
+
+    /**
+     * Feed one GPU timing sample and update the render scale.
+     *
+     * @param gpuMs Measured GPU time of the scene pass in milliseconds
+     */
+    void update(float gpuMs) {
+        if (gpuMs <= 0.0f) return;
+
+        // Light smoothing so one noisy frame doesn't move the scale much
+        if (smoothedGpuMs <= 0.0f) {
+            smoothedGpuMs = gpuMs;
+        } else {
+            smoothedGpuMs += (gpuMs - smoothedGpuMs) * 0.25f;
+        }
+
+        if (!enabled) {
+            scale = maxScale;
+            return;
+        }
+
+        // Pixel cost ~ scale^2, so the ideal scale goes with sqrt of the ratio
+        float budget = targetFrameMs * headroom;
+        float idealScale = scale * std::sqrt(budget / smoothedGpuMs);
+        idealScale = std::clamp(idealScale, minScale, maxScale);
+
+        // Steps snap to 1/64 so the target size doesn't jitter every frame.
+        // They round away from the current scale: rounding to nearest would
+        // undo the small steps near the ideal and leave the scale stuck.
+        if (idealScale < scale) {
+            // Over budget: drop fast
+            scale += (idealScale - scale) * 0.5f;
+            scale = std::floor(scale * 64.0f) / 64.0f;
+        } else if (smoothedGpuMs < budget * 0.85f) {
+            // Clear headroom: creep back up
+            scale += (idealScale - scale) * 0.05f;
+            scale = std::ceil(scale * 64.0f) / 64.0f;
+        }
+        scale = std::clamp(scale, minScale, maxScale);
+    }
+
+    int scaledWidth(int screenWidth) const {
+        return std::max(1, static_cast<int>(screenWidth * currentScale()));
+    }
+
+    int scaledHeight(int screenHeight) const {
+        return std::max(1, static_cast<int>(screenHeight * currentScale()));
+    }
+
+    float currentScale() const {
+        return enabled ? scale : maxScale;
+    }
+};
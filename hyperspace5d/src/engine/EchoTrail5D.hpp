@@ -0,0 +1,109 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * EchoTrail5D - A platform repeated as a row of fading echoes
+ *
+ * One source box plus copies offset by a fixed 5D step: copy i sits at
+ * position + echoStep * i for i in [firstEcho, lastEcho]. A trail left by
+ * something moving at constant velocity is the same shape with
+ * echoStep = -velocity * interval.
+ *
+ * The trail is a single object: it is drawn with one instanced draw (echo
+ * placement, fade and hidden-dimension effects are computed per instance
+ * in the vertex shader). Collision tests each copy as a box of its own,
+ * so something touching two copies gets a contact with each; point
+ * queries only need the copy nearest the point.
+ */
+class EchoTrail5D : public Platform5D {
+public:
+    Vec5D echoStep;           // Offset between consecutive echoes
+    int firstEcho;            // Lowest echo index (may be negative)
+    int lastEcho;             // Highest echo index
+    float echoFade;           // Opacity change per step away from echo 0
+    glm::vec3 echoColorStep;  // Color change per echo index
+
+    static int tag() {
+        static const int type = ObjectType5D::intern("EchoTrail");
+        return type;
+    }
+
+    EchoTrail5D(const Vec5D& pos, const Vec5D& sz, const Vec5D& step, int first, int last)
+        : Platform5D(pos, sz)
+        , echoStep(step)
+        , firstEcho(first)
+        , lastEcho(last)
+        , echoFade(0.0f)
+        , echoColorStep(0.0f)
+    {
+        typeTag = tag();
+    }
+
+    int echoCount() const {
+        return lastEcho - firstEcho + 1;
+    }
+
+    Vec5D echoPosition(int index) const {
+        return position() + echoStep * static_cast<float>(index);
+    }
+
+    float echoOpacity(int index) const {
+        return std::clamp(opacity() + echoFade * std::abs(index), 0.0f, 1.0f);
+    }
+
+    /**
+     * Index of the echo whose center is closest to a point.
+     *
+     * Echo centers lie on a line, so the nearest one is found by projecting
+     * onto the step direction; the neighbours are checked as well since the
+     * boxes aren't spheres.
+     */
+    int nearestEcho(const Vec5D& point) const {
+        float stepLengthSq = echoStep.magnitudeSquared();
+        if (stepLengthSq < 1e-8f) return firstEcho;
+
+        float t = (point - position()).dot(echoStep) / stepLengthSq;
+        int guess = std::clamp(static_cast<int>(std::lround(t)), firstEcho, lastEcho);
+
+        int best = guess;
+        float bestDistSq = (echoPosition(guess) - point).magnitudeSquared();
+        for (int index = guess - 1; index <= guess + 1; index += 2) {
+            if (index < firstEcho || index > lastEcho) continue;
+            float distSq = (echoPosition(index) - point).magnitudeSquared();
+            if (distSq < bestDistSq) {
+                bestDistSq = distSq;
+                best = index;
+            }
+        }
+        return best;
+    }
+
+    void describe(EntityDesc5D& desc) const override {
+        // Several boxes, which a single table row can't describe
+        (void)desc;
+    }
+
+    Vec5D collisionCenter(const Vec5D& point) const override {
+        return echoPosition(nearestEcho(point));
+    }
+
+    int instanceCount() const override {
+        return echoCount();
+    }
+
+    Vec5D instancePosition(int instance) const override {
+        return echoPosition(firstEcho + instance);
+    }
+
+    void getBounds(Vec5D& outMin, Vec5D& outMax) const override {
+        Vec5D first = echoPosition(firstEcho);
+        Vec5D last = echoPosition(lastEcho);
+        for (int i = 0; i < 5; ++i) {
+            outMin[i] = std::min(first[i], last[i]) - size()[i] * 0.5f;
+            outMax[i] = std::max(first[i], last[i]) + size()[i] * 0.5f;
+        }
+    }
+};
@@ -0,0 +1,474 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * EntityTable5D - The rows of one archetype: the objects they drive and
+ * their bodies
+ *
+ * Every body field (Body5D) is a column here, and each archetype's table
+ * adds its own component columns; row i of every column belongs to
+ * object[i]. While an object has a row it reads and writes its body
+ * through columns, so systems, collision and rendering can walk the
+ * columns in order. Removing a row hands the body back to the object and
+ * moves the last row into the hole.
+ */
+struct EntityTable5D {
+    std::vector<GameObject5D*> object;
+    std::vector<Vec5D> position;
+    std::vector<Vec5D> previousPosition;
+    std::vector<Vec5D> velocity;
+    std::vector<Vec5D> size;
+    std::vector<Vec5D> boundsMin;
+    std::vector<Vec5D> boundsMax;
+    std::vector<glm::vec3> color;
+    std::vector<float> opacity;
+    std::vector<float> lightIntensity;
+    std::vector<float> lightRadius;
+    std::vector<uint8_t> visible;
+    BodyColumns5D columns;          // Over the body columns above, for the rows' objects
+
+    EntityTable5D() = default;
+
+    // The rows' objects point at columns
+    EntityTable5D(const EntityTable5D&) = delete;
+    EntityTable5D& operator=(const EntityTable5D&) = delete;
+
+    int rowCount() const {
+        return static_cast<int>(object.size());
+    }
+
+protected:
+    int pushObject(GameObject5D* obj) {
+        Body5D body = obj->body->get(obj->bodyRow);
+        position.push_back(body.position);
+        previousPosition.push_back(body.previousPosition);
+        velocity.push_back(body.velocity);
+        size.push_back(body.size);
+        boundsMin.push_back(body.boundsMin);
+        boundsMax.push_back(body.boundsMax);
+        color.push_back(body.color);
+        opacity.push_back(body.opacity);
+        lightIntensity.push_back(body.lightIntensity);
+        lightRadius.push_back(body.lightRadius);
+        visible.push_back(body.visible);
+        object.push_back(obj);
+
+        // A push may have moved the columns
+        bindColumns();
+        int row = rowCount() - 1;
+        obj->attachBody(&columns, row);
+        return row;
+    }
+
+    void removeObject(int row) {
+        object[row]->detachBody();
+        moveLast(position, row);
+        moveLast(previousPosition, row);
+        moveLast(velocity, row);
+        moveLast(size, row);
+        moveLast(boundsMin, row);
+        moveLast(boundsMax, row);
+        moveLast(color, row);
+        moveLast(opacity, row);
+        moveLast(lightIntensity, row);
+        moveLast(lightRadius, row);
+        moveLast(visible, row);
+        moveLast(object, row);
+        if (row < rowCount()) {
+            object[row]->entityRow = row;
+            object[row]->attachBody(&columns, row);
+        }
+    }
+
+    void clearObjects() {
+        for (GameObject5D* obj : object) {
+            obj->detachBody();
+        }
+        position.clear();
+        previousPosition.clear();
+        velocity.clear();
+        size.clear();
+        boundsMin.clear();
+        boundsMax.clear();
+        color.clear();
+        opacity.clear();
+        lightIntensity.clear();
+        lightRadius.clear();
+        visible.clear();
+        object.clear();
+    }
+
+    template<typename T>
+    static void moveLast(std::vector<T>& column, int row) {
+        column[row] = column.back();
+        column.pop_back();
+    }
+
+private:
+    void bindColumns() {
+        columns.position = position.data();
+        columns.previousPosition = previousPosition.data();
+        columns.velocity = velocity.data();
+        columns.size = size.data();
+        columns.boundsMin = boundsMin.data();
+        columns.boundsMax = boundsMax.data();
+        columns.color = color.data();
+        columns.opacity = opacity.data();
+        columns.lightIntensity = lightIntensity.data();
+        columns.lightRadius = lightRadius.data();
+        columns.visible = visible.data();
+    }
+};
+
+/**
+ * MoverTable5D - Back and forth between two points with smoothstep easing
+ */
+struct MoverTable5D : EntityTable5D {
+    std::vector<Vec5D> pathStart;
+    std::vector<Vec5D> pathEnd;
+    std::vector<float> pathSpeed;
+    std::vector<float> pathProgress;
+    std::vector<uint8_t> pathForward;
+    std::vector<int> proxy;         // Broadphase proxy, -1 until looked up
+
+    int push(GameObject5D* obj, const EntityDesc5D& desc) {
+        pathStart.push_back(desc.pathStart);
+        pathEnd.push_back(desc.pathEnd);
+        pathSpeed.push_back(desc.pathSpeed);
+        pathProgress.push_back(0.0f);
+        pathForward.push_back(1);
+        proxy.push_back(-1);
+        return pushObject(obj);
+    }
+
+    void swapRemove(int row) {
+        moveLast(pathStart, row);
+        moveLast(pathEnd, row);
+        moveLast(pathSpeed, row);
+        moveLast(pathProgress, row);
+        moveLast(pathForward, row);
+        moveLast(proxy, row);
+        removeObject(row);
+    }
+
+    void clear() {
+        pathStart.clear();
+        pathEnd.clear();
+        pathSpeed.clear();
+        pathProgress.clear();
+        pathForward.clear();
+        proxy.clear();
+        clearObjects();
+    }
+};
+
+/**
+ * PulserTable5D - opacity = base + amplitude * sin(time * rate)
+ */
+struct PulserTable5D : EntityTable5D {
+    std::vector<float> pulseTime;
+    std::vector<float> pulseRate;
+    std::vector<float> pulseBase;
+    std::vector<float> pulseAmplitude;
+
+    int push(GameObject5D* obj, const EntityDesc5D& desc) {
+        pulseTime.push_back(0.0f);
+        pulseRate.push_back(desc.pulseRate);
+        pulseBase.push_back(desc.pulseBase);
+        pulseAmplitude.push_back(desc.pulseAmplitude);
+        return pushObject(obj);
+    }
+
+    void swapRemove(int row) {
+        moveLast(pulseTime, row);
+        moveLast(pulseRate, row);
+        moveLast(pulseBase, row);
+        moveLast(pulseAmplitude, row);
+        removeObject(row);
+    }
+
+    void clear() {
+        pulseTime.clear();
+        pulseRate.clear();
+        pulseBase.clear();
+        pulseAmplitude.clear();
+        clearObjects();
+    }
+};
+
+/**
+ * ProjectileTable5D - Straight-line motion, fading out and expiring at maxAge
+ */
+struct ProjectileTable5D : EntityTable5D {
+    std::vector<float> age;
+    std::vector<float> maxAge;
+
+    int push(GameObject5D* obj, const EntityDesc5D& desc) {
+        age.push_back(0.0f);
+        maxAge.push_back(desc.lifetime);
+        return pushObject(obj);
+    }
+
+    void swapRemove(int row) {
+        moveLast(age, row);
+        moveLast(maxAge, row);
+        removeObject(row);
+    }
+
+    void clear() {
+        age.clear();
+        maxAge.clear();
+        clearObjects();
+    }
+};
+
+/**
+ * PlatformTable5D - Static boxes: no components, and no system
+ */
+struct PlatformTable5D : EntityTable5D {
+    int push(GameObject5D* obj, const EntityDesc5D&) {
+        return pushObject(obj);
+    }
+
+    void swapRemove(int row) {
+        removeObject(row);
+    }
+
+    void clear() {
+        clearObjects();
+    }
+};
+
+/**
+ * EntityStore5D - Component storage for the level's simple objects
+ *
+ * Objects that describe themselves with an archetype (static platforms,
+ * moving platforms, goals and boss cores, projectiles) get a row in that
+ * archetype's table, and their per-frame behaviour runs here as systems
+ * that walk the columns in order instead of a virtual update() per
+ * object.
+ *
+ * A row holds the object's whole body (position, velocity, bounds,
+ * render state) next to the archetype's components, so the systems read
+ * and write columns only. The collision code and the renderer walk the
+ * same columns through forEachTable(); code holding an object reaches
+ * its row through the object's body accessors. Scripts that change an
+ * object's path call refresh().
+ */
+class EntityStore5D {
+public:
+    /**
+     * What the systems have advanced for one row (path progress, pulse
+     * phase, age); the body is captured with the object's common fields.
+     */
+    struct RowState {
+        float pathProgress;
+        float pulseTime;
+        float age;
+        uint8_t pathForward;
+    };
+
+    MoverTable5D movers;
+    PulserTable5D pulsers;
+    ProjectileTable5D projectiles;
+    PlatformTable5D platforms;
+
+    void clear() {
+        releaseRows(movers);
+        releaseRows(pulsers);
+        releaseRows(projectiles);
+        releaseRows(platforms);
+        movers.clear();
+        pulsers.clear();
+        projectiles.clear();
+        platforms.clear();
+    }
+
+    /**
+     * Call fn with each table, for code that walks every row's body.
+     */
+    template<typename Fn>
+    void forEachTable(Fn&& fn) {
+        fn(static_cast<EntityTable5D&>(movers));
+        fn(static_cast<EntityTable5D&>(pulsers));
+        fn(static_cast<EntityTable5D&>(projectiles));
+        fn(static_cast<EntityTable5D&>(platforms));
+    }
+
+    template<typename Fn>
+    void forEachTable(Fn&& fn) const {
+        fn(static_cast<const EntityTable5D&>(movers));
+        fn(static_cast<const EntityTable5D&>(pulsers));
+        fn(static_cast<const EntityTable5D&>(projectiles));
+        fn(static_cast<const EntityTable5D&>(platforms));
+    }
+
+    /**
+     * Give an object a row if it has an archetype. Returns false if the
+     * object keeps updating itself.
+     */
+    bool add(GameObject5D* obj) {
+        EntityDesc5D desc;
+        obj->describe(desc);
+        switch (desc.archetype) {
+            case EntityDesc5D::Mover: obj->entityRow = movers.push(obj, desc); break;
+            case EntityDesc5D::Pulser: obj->entityRow = pulsers.push(obj, desc); break;
+            case EntityDesc5D::Projectile: obj->entityRow = projectiles.push(obj, desc); break;
+            case EntityDesc5D::Platform: obj->entityRow = platforms.push(obj, desc); break;
+            default: return false;
+        }
+        obj->entityArchetype = desc.archetype;
+        return true;
+    }
+
+    /**
+     * Drop an object's row; its body goes back into the object as the
+     * systems last wrote it.
+     */
+    void remove(GameObject5D* obj) {
+        int row = obj->entityRow;
+        if (row < 0) return;
+        switch (obj->entityArchetype) {
+            case EntityDesc5D::Mover: movers.swapRemove(row); break;
+            case EntityDesc5D::Pulser: pulsers.swapRemove(row); break;
+            case EntityDesc5D::Projectile: projectiles.swapRemove(row); break;
+            case EntityDesc5D::Platform: platforms.swapRemove(row); break;
+        }
+        obj->entityRow = -1;
+    }
+
+    /**
+     * Re-read a mover's path after a script changed it on the object.
+     * Progress along the path is kept.
+     */
+    void refresh(GameObject5D* obj) {
+        if (!hasRow(obj, EntityDesc5D::Mover)) return;
+        EntityDesc5D desc;
+        obj->describe(desc);
+        int row = obj->entityRow;
+        movers.pathStart[row] = desc.pathStart;
+        movers.pathEnd[row] = desc.pathEnd;
+        movers.pathSpeed[row] = desc.pathSpeed;
+    }
+
+    bool isExpired(const GameObject5D* obj) const {
+        if (!hasRow(obj, EntityDesc5D::Projectile)) return false;
+        return projectiles.age[obj->entityRow] >= projectiles.maxAge[obj->entityRow];
+    }
+
+    /**
+     * End a projectile's lifetime now.
+     */
+    void expire(const GameObject5D* obj) {
+        if (!hasRow(obj, EntityDesc5D::Projectile)) return;
+        projectiles.age[obj->entityRow] = projectiles.maxAge[obj->entityRow];
+    }
+
+    void saveRow(const GameObject5D* obj, RowState& state) const {
+        int row = obj->entityRow;
+        if (hasRow(obj, EntityDesc5D::Mover)) {
+            state.pathProgress = movers.pathProgress[row];
+            state.pathForward = movers.pathForward[row];
+        } else if (hasRow(obj, EntityDesc5D::Pulser)) {
+            state.pulseTime = pulsers.pulseTime[row];
+        } else if (hasRow(obj, EntityDesc5D::Projectile)) {
+            state.age = projectiles.age[row];
+        }
+    }
+
+    void loadRow(const GameObject5D* obj, const RowState& state) {
+        int row = obj->entityRow;
+        if (hasRow(obj, EntityDesc5D::Mover)) {
+            movers.pathProgress[row] = state.pathProgress;
+            movers.pathForward[row] = state.pathForward;
+        } else if (hasRow(obj, EntityDesc5D::Pulser)) {
+            pulsers.pulseTime[row] = state.pulseTime;
+        } else if (hasRow(obj, EntityDesc5D::Projectile)) {
+            projectiles.age[row] = state.age;
+        }
+    }
+
+    /**
+     * Proxies were rebuilt; look them up again on next use.
+     */
+    void resetProxies() {
+        std::fill(movers.proxy.begin(), movers.proxy.end(), -1);
+    }
+
+    /**
+     * Run every system.
+     */
+    void update(float deltaTime) {
+        updateMovers(deltaTime);
+        updatePulsers(deltaTime);
+        updateProjectiles(deltaTime);
+    }
+
+    int getEntityCount() const {
+        return movers.rowCount() + pulsers.rowCount() + projectiles.rowCount() + platforms.rowCount();
+    }
+
+private:
+    static void releaseRows(const EntityTable5D& entities) {
+        for (GameObject5D* obj : entities.object) {
+            obj->entityRow = -1;
+        }
+    }
+
+    static bool hasRow(const GameObject5D* obj, int archetype) {
+        return obj->entityRow >= 0 && obj->entityArchetype == archetype;
+    }
+
+    void updateMovers(float deltaTime) {
+        MoverTable5D& t = movers;
+        for (int i = 0; i < t.rowCount(); ++i) {
+            float progress = t.pathProgress[i];
+            if (t.pathForward[i]) {
+                progress += t.pathSpeed[i] * deltaTime;
+                if (progress >= 1.0f) {
+                    progress = 1.0f;
+                    t.pathForward[i] = 0;
+                }
+            } else {
+                progress -= t.pathSpeed[i] * deltaTime;
+                if (progress <= 0.0f) {
+                    progress = 0.0f;
+                    t.pathForward[i] = 1;
+                }
+            }
+            t.pathProgress[i] = progress;
+
+            // Smooth interpolation
+            float eased = progress * progress * (3.0f - 2.0f * progress);
+            Vec5D span = t.pathEnd[i] - t.pathStart[i];
+            t.previousPosition[i] = t.position[i];
+            t.position[i] = t.pathStart[i] + span * eased;
+            t.velocity[i] = span * t.pathSpeed[i] * (t.pathForward[i] ? 1.0f : -1.0f);
+            t.columns.updateBounds(i);
+        }
+    }
+
+    void updatePulsers(float deltaTime) {
+        PulserTable5D& t = pulsers;
+        for (int i = 0; i < t.rowCount(); ++i) {
+            t.pulseTime[i] += deltaTime;
+            t.opacity[i] = t.pulseBase[i] + t.pulseAmplitude[i] * std::sin(t.pulseTime[i] * t.pulseRate[i]);
+        }
+    }
+
+    void updateProjectiles(float deltaTime) {
+        ProjectileTable5D& t = projectiles;
+        for (int i = 0; i < t.rowCount(); ++i) {
+            t.age[i] += deltaTime;
+            t.previousPosition[i] = t.position[i];
+            t.position[i] += t.velocity[i] * deltaTime;
+            t.columns.updateBounds(i);
+            t.opacity[i] = 1.0f - t.age[i] / t.maxAge[i];
+        }
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <span>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * AllocationCounter - Number of global operator new calls so far
+ *
+ * main.cpp replaces the global allocation functions so that each one bumps
+ * this. Reading it before and after a frame tells whether the frame touched
+ * the heap; after warm-up it should not.
+ */
+struct AllocationCounter {
+    static std::atomic<uint64_t>& total() {
+        static std::atomic<uint64_t> count(0);
+        return count;
+    }
+
+    static uint64_t count() {
+        return total().load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * FrameArena - Scratch memory that lives until the end of the frame
+ *
+ * Allocating bumps an offset into one block, and reset() at the start of the
+ * next frame frees everything at once. Only trivially destructible types
+ * go in it, since nothing is destroyed.
+ *
+ * A frame that needs more than the block holds takes the rest from the heap;
+ * the next reset() regrows the block to that frame's peak, so after the first
+ * few frames the arena stops allocating.
+ */
+class FrameArena {
+public:
+    static constexpr size_t Alignment = 64;
+
+    explicit FrameArena(size_t bytes = 64 * 1024)
+        : block(allocateBlock(bytes))
+        , blockSize(bytes)
+        , offset(0)
+        , overflowBytes(0)
+        , peak(0)
+    {}
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * Uninitialized room for count objects of type T, valid until reset().
+     */
+    template<typename T>
+    std::span<T> allocate(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors");
+        static_assert(alignof(T) <= Alignment, "FrameArena alignment too small");
+        if (count == 0) return std::span<T>();
+
+        size_t bytes = count * sizeof(T);
+        size_t start = (offset + alignof(T) - 1) & ~(alignof(T) - 1);
+        unsigned char* memory;
+        if (start + bytes <= blockSize) {
+            memory = block.get() + start;
+            offset = start + bytes;
+        } else {
+            overflow.push_back(allocateBlock(bytes));
+            memory = overflow.back().get();
+            overflowBytes += bytes + Alignment;
+        }
+        peak = std::max(peak, offset + overflowBytes);
+        return std::span<T>(reinterpret_cast<T*>(memory), count);
+    }
+
+    /**
+     * Free everything allocated this frame.
+     */
+    void reset() {
+        if (!overflow.empty()) {
+            overflow.clear();
+            blockSize = std::max(blockSize * 2, peak);
+            block = allocateBlock(blockSize);
+        }
+        offset = 0;
+        overflowBytes = 0;
+    }
+
+    size_t getUsed() const {
+        return offset + overflowBytes;
+    }
+
+    size_t getCapacity() const {
+        return blockSize;
+    }
+
+    size_t getPeak() const {
+        return peak;
+    }
+
+private:
+    struct AlignedDelete {
+        void operator()(unsigned char* memory) const {
+            ::operator delete[](memory, std::align_val_t(Alignment));
+        }
+    };
+    using Block = std::unique_ptr<unsigned char[], AlignedDelete>;
+
+    Block block;
+    size_t blockSize;
+    size_t offset;
+    std::vector<Block> overflow;    // Heap blocks for what didn't fit this frame
+    size_t overflowBytes;
+    size_t peak;                    // Most bytes any frame has used
+
+    static Block allocateBlock(size_t bytes) {
+        return Block(static_cast<unsigned char*>(::operator new[](bytes, std::align_val_t(Alignment))));
+    }
+};
@@ -1,67 +1,363 @@
 #pragma once
 
 #include "../core/Vec5D.hpp"
+#include "Handle5D.hpp"
 #include <glm/glm.hpp>
 #include <string>
 #include <memory>
+#include <vector>
+#include <cmath>
+#include <cstdint>
 
 /**
- * GameObject5D - Base class for all objects existing in 5D space
- * 
- * All game entities inherit from this: player, platforms, obstacles, etc.
+ * ObjectType5D - Interned object type tags
+ *
+ * Each object class interns its type name once and stamps the resulting
+ * small integer on its instances, so asking what an object is costs an
+ * int compare and levels can keep one list per type.
  */
-class GameObject5D {
+class ObjectType5D {
 public:
+    static int intern(const std::string& name) {
+        std::vector<std::string>& names = registry();
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) return static_cast<int>(i);
+        }
+        names.push_back(name);
+        return static_cast<int>(names.size()) - 1;
+    }
+
+    static const std::string& name(int tag) {
+        return registry()[tag];
+    }
+
+    static int count() {
+        return static_cast<int>(registry().size());
+    }
+
+private:
+    static std::vector<std::string>& registry() {
+        static std::vector<std::string> names;
+        return names;
+    }
+};
+
+/**
+ * EntityDesc5D - What an object contributes to the level's entity store
+ *
+ * archetype picks the table (None keeps the object on its own update());
+ * the other fields seed that archetype's components.
+ */
+struct EntityDesc5D {
+    static constexpr int None = -1;
+    static constexpr int Mover = 0;         // Path between two points
+    static constexpr int Pulser = 1;        // Pulsing opacity
+    static constexpr int Projectile = 2;    // Straight-line motion, fades out over a lifetime
+    static constexpr int Platform = 3;      // Static box; no system, just its body in the table
+
+    int archetype;
+    Vec5D pathStart;
+    Vec5D pathEnd;
+    float pathSpeed;
+    float pulseRate;
+    float pulseBase;
+    float pulseAmplitude;
+    float lifetime;
+
+    EntityDesc5D()
+        : archetype(None)
+        , pathSpeed(0.0f)
+        , pulseRate(0.0f)
+        , pulseBase(1.0f)
+        , pulseAmplitude(0.0f)
+        , lifetime(0.0f)
+    {}
+};
+
+/**
+ * Body5D - Transform, motion, bounds and render state of one object
+ *
+ * An object holds its body inline until it joins an entity table; the
+ * table keeps the same fields as columns (EntityTable5D).
+ */
+struct Body5D {
     Vec5D position;           // Position in 5D space
+    Vec5D previousPosition;   // Position at the start of the last simulation step
     Vec5D velocity;           // Velocity in 5D space
     Vec5D size;               // Bounding box size in each dimension
-    
+    Vec5D boundsMin;          // position - size / 2, refreshed by updateBounds()
+    Vec5D boundsMax;          // position + size / 2
     glm::vec3 color;          // Base color
     float opacity;            // Transparency (0-1)
-    
-    bool isStatic;            // Static objects don't move
-    bool isSolid;             // Solid objects have collision
-    bool isVisible;           // Visibility flag
-    
-    std::string name;         // Object identifier
-    int id;                   // Unique ID
+    float lightIntensity;     // Emits a point light in its color if > 0
+    float lightRadius;        // Light reach in 5D units
+    uint8_t visible;          // Visibility flag
 
-    GameObject5D()
+    Body5D()
         : position()
+        , previousPosition()
         , velocity()
         , size(0.5f, 0.5f, 0.5f, 0.5f, 0.5f)
+        , boundsMin()
+        , boundsMax()
         , color(1.0f, 1.0f, 1.0f)
         , opacity(1.0f)
+        , lightIntensity(0.0f)
+        , lightRadius(0.0f)
+        , visible(1)
+    {}
+};
+
+/**
+ * BodyColumns5D - One array per Body5D field; row i of each is one body
+ *
+ * Objects read their body through one of these: their entity table's, or
+ * a single-row one over their own inline Body5D.
+ */
+struct BodyColumns5D {
+    Vec5D* position;
+    Vec5D* previousPosition;
+    Vec5D* velocity;
+    Vec5D* size;
+    Vec5D* boundsMin;
+    Vec5D* boundsMax;
+    glm::vec3* color;
+    float* opacity;
+    float* lightIntensity;
+    float* lightRadius;
+    uint8_t* visible;
+
+    BodyColumns5D()
+        : position(nullptr)
+        , previousPosition(nullptr)
+        , velocity(nullptr)
+        , size(nullptr)
+        , boundsMin(nullptr)
+        , boundsMax(nullptr)
+        , color(nullptr)
+        , opacity(nullptr)
+        , lightIntensity(nullptr)
+        , lightRadius(nullptr)
+        , visible(nullptr)
+    {}
+
+    explicit BodyColumns5D(Body5D& body)
+        : position(&body.position)
+        , previousPosition(&body.previousPosition)
+        , velocity(&body.velocity)
+        , size(&body.size)
+        , boundsMin(&body.boundsMin)
+        , boundsMax(&body.boundsMax)
+        , color(&body.color)
+        , opacity(&body.opacity)
+        , lightIntensity(&body.lightIntensity)
+        , lightRadius(&body.lightRadius)
+        , visible(&body.visible)
+    {}
+
+    Body5D get(int row) const {
+        Body5D body;
+        body.position = position[row];
+        body.previousPosition = previousPosition[row];
+        body.velocity = velocity[row];
+        body.size = size[row];
+        body.boundsMin = boundsMin[row];
+        body.boundsMax = boundsMax[row];
+        body.color = color[row];
+        body.opacity = opacity[row];
+        body.lightIntensity = lightIntensity[row];
+        body.lightRadius = lightRadius[row];
+        body.visible = visible[row];
+        return body;
+    }
+
+    /**
+     * Recompute a row's bounds from its position and size.
+     */
+    void updateBounds(int row) const {
+        Vec5D half = size[row] * 0.5f;
+        boundsMin[row] = position[row] - half;
+        boundsMax[row] = position[row] + half;
+    }
+};
+
+/**
+ * GameObject5D - Base class for all objects existing in 5D space
+ * 
+ * All game entities inherit from this: player, platforms, obstacles, etc.
+ *
+ * The body (position, velocity, size, bounds, color, ...) is not stored
+ * in the object: an object with an entity table row reads it from that
+ * table's columns, any other object from its inline local body, both
+ * through the body pointer. The accessors hide which.
+ *
+ * Members are laid out by how often collision code reads them. The first
+ * 64-byte line holds the vtable pointer, the body reference and the flags
+ * every overlap test and broadphase pass looks at. Bookkeeping fields and
+ * the inline body come after, so the collision loops never pull them
+ * into cache for objects that have a row.
+ */
+class alignas(64) GameObject5D {
+public:
+    // Line 0: read by every overlap test
+    const BodyColumns5D* body;  // Columns holding the body: a table's, or localColumns
+    int bodyRow;              // Row of the body in them
+    float inverseMass;        // 0 = never pushed by contacts (static or scripted motion)
+    int id;                   // Unique ID
+    bool isStatic;            // Static objects don't move
+    bool isSolid;             // Solid objects have collision
+    bool isAwake;             // In the level's active set (updated every frame)
+    bool isTransient;         // Short-lived; indexed by the spatial hash, not the broadphase
+    bool isTrigger;           // Reports the player entering/leaving it (goals, portals, ...)
+    float restTime;           // How long the object has been able to sleep
+    int entityArchetype;      // Entity store table, valid while entityRow >= 0
+    int entityRow;            // Row in that table, -1 if the object updates itself
+    int levelSlot;            // Index in the level's object list, -1 if not in one
+    int activeSlot;           // Index in the level's active list, -1 if not in it
+
+    // Cold: bookkeeping and the inline body
+    int transientSlot;        // Index in the level's transient list, -1 if not in it
+    int sceneNode;            // Node placing it in the level's scene graph, -1 if none
+    int typeSlot;             // Index in the level's list for this type
+    Handle5D handle;          // Stable reference while in a level (Level::resolve)
+    int typeTag;              // Interned type (ObjectType5D)
+    Body5D local;             // The body while the object has no table row
+    BodyColumns5D localColumns;   // Single-row columns over local
+
+    GameObject5D()
+        : body(&localColumns)
+        , bodyRow(0)
+        , inverseMass(0.0f)
+        , id(0)
         , isStatic(false)
         , isSolid(true)
-        , isVisible(true)
-        , name("GameObject")
-        , id(0)
-    {}
+        , isAwake(false)
+        , isTransient(false)
+        , isTrigger(false)
+        , restTime(0.0f)
+        , entityArchetype(EntityDesc5D::None)
+        , entityRow(-1)
+        , levelSlot(-1)
+        , activeSlot(-1)
+        , transientSlot(-1)
+        , sceneNode(-1)
+        , typeSlot(-1)
+        , handle()
+        , typeTag(tag())
+        , local()
+        , localColumns(local)
+    {
+        updateBounds();
+    }
+
+    // The body pointer may point into the object itself
+    GameObject5D(const GameObject5D&) = delete;
+    GameObject5D& operator=(const GameObject5D&) = delete;
 
     virtual ~GameObject5D() = default;
 
+    static int tag() {
+        static const int type = ObjectType5D::intern("GameObject");
+        return type;
+    }
+
+    Vec5D& position() { return body->position[bodyRow]; }
+    const Vec5D& position() const { return body->position[bodyRow]; }
+    Vec5D& previousPosition() { return body->previousPosition[bodyRow]; }
+    const Vec5D& previousPosition() const { return body->previousPosition[bodyRow]; }
+    Vec5D& velocity() { return body->velocity[bodyRow]; }
+    const Vec5D& velocity() const { return body->velocity[bodyRow]; }
+    Vec5D& size() { return body->size[bodyRow]; }
+    const Vec5D& size() const { return body->size[bodyRow]; }
+    const Vec5D& boundsMin() const { return body->boundsMin[bodyRow]; }
+    const Vec5D& boundsMax() const { return body->boundsMax[bodyRow]; }
+    glm::vec3& color() { return body->color[bodyRow]; }
+    const glm::vec3& color() const { return body->color[bodyRow]; }
+    float& opacity() { return body->opacity[bodyRow]; }
+    float opacity() const { return body->opacity[bodyRow]; }
+    float& lightIntensity() { return body->lightIntensity[bodyRow]; }
+    float lightIntensity() const { return body->lightIntensity[bodyRow]; }
+    float& lightRadius() { return body->lightRadius[bodyRow]; }
+    float lightRadius() const { return body->lightRadius[bodyRow]; }
+    bool isVisible() const { return body->visible[bodyRow] != 0; }
+    void setVisible(bool visible) { body->visible[bodyRow] = visible ? 1 : 0; }
+
+    /**
+     * Read the body from a table row from now on. The table has already
+     * copied the current body into that row.
+     */
+    void attachBody(const BodyColumns5D* columns, int row) {
+        body = columns;
+        bodyRow = row;
+    }
+
+    /**
+     * Take the body back from the table row before the row goes away.
+     */
+    void detachBody() {
+        if (body == &localColumns) return;
+        local = body->get(bodyRow);
+        body = &localColumns;
+        bodyRow = 0;
+    }
+
     /**
      * Update object physics and logic
      */
     virtual void update(float deltaTime) {
         if (!isStatic) {
-            position += velocity * deltaTime;
+            position() += velocity() * deltaTime;
         }
     }
 
+    /**
+     * Whether update() would do nothing right now, so the object can leave
+     * the active set. Objects that animate or move on their own override
+     * this.
+     */
+    virtual bool canSleep() const {
+        return isStatic || velocity().magnitudeSquared() < 1e-8f;
+    }
+
+    /**
+     * Fill in the archetype and components the entity store should run
+     * this object as. The default leaves it to update().
+     */
+    virtual void describe(EntityDesc5D& desc) const {
+        (void)desc;
+    }
+
+    /**
+     * State a level snapshot has to keep beyond the common fields (health,
+     * activation, path ends). Writes at most MaxCustomState floats and
+     * returns how many; loadCustomState reads the same floats back.
+     */
+    static constexpr int MaxCustomState = 16;
+
+    virtual int saveCustomState(float* out) const {
+        (void)out;
+        return 0;
+    }
+
+    virtual void loadCustomState(const float* in) {
+        (void)in;
+    }
+
+    /**
+     * Recompute the bounds after position or size changed. Code
+     * that moves objects calls this before the next collision query.
+     */
+    void updateBounds() {
+        body->updateBounds(bodyRow);
+    }
+
     /**
      * Check if this object intersects another in 5D space
      */
     bool intersects(const GameObject5D& other) const {
         // AABB (Axis-Aligned Bounding Box) collision in 5D
         for (int i = 0; i < 5; ++i) {
-            float min1 = position[i] - size[i] * 0.5f;
-            float max1 = position[i] + size[i] * 0.5f;
-            float min2 = other.position[i] - other.size[i] * 0.5f;
-            float max2 = other.position[i] + other.size[i] * 0.5f;
-            
-            if (max1 < min2 || max2 < min1) {
+            if (boundsMax()[i] < other.boundsMin()[i] || other.boundsMax()[i] < boundsMin()[i]) {
                 return false;  // No overlap in this dimension
             }
         }
@@ -72,25 +368,53 @@ public:
      * Get the minimum corner of the bounding box
      */
     Vec5D getMin() const {
-        return position - size * 0.5f;
+        return position() - size() * 0.5f;
     }
 
     /**
      * Get the maximum corner of the bounding box
      */
     Vec5D getMax() const {
-        return position + size * 0.5f;
+        return position() + size() * 0.5f;
+    }
+
+    /**
+     * Get the box covering the whole object (all instances)
+     */
+    virtual void getBounds(Vec5D& outMin, Vec5D& outMax) const {
+        outMin = boundsMin();
+        outMax = boundsMax();
+    }
+
+    /**
+     * Center of the box that collision against a point should use.
+     * Objects made of several boxes return the one nearest the point.
+     */
+    virtual Vec5D collisionCenter(const Vec5D& point) const {
+        (void)point;
+        return position();
+    }
+
+    /**
+     * Number of boxes of this object's size drawn/collided (1 for most objects)
+     */
+    virtual int instanceCount() const {
+        return 1;
+    }
+
+    virtual Vec5D instancePosition(int instance) const {
+        (void)instance;
+        return position();
     }
 
     /**
      * Check if a point is inside this object
      */
     bool contains(const Vec5D& point) const {
-        Vec5D min = getMin();
-        Vec5D max = getMax();
+        Vec5D center = collisionCenter(point);
         
         for (int i = 0; i < 5; ++i) {
-            if (point[i] < min[i] || point[i] > max[i]) {
+            if (std::abs(point[i] - center[i]) > size()[i] * 0.5f) {
                 return false;
             }
         }
@@ -103,16 +427,25 @@ public:
  */
 class Platform5D : public GameObject5D {
 public:
+    static int tag() {
+        static const int type = ObjectType5D::intern("Platform");
+        return type;
+    }
+
     Platform5D() {
         isStatic = true;
         isSolid = true;
-        color = glm::vec3(0.7f, 0.7f, 0.8f);
-        name = "Platform";
+        color() = glm::vec3(0.7f, 0.7f, 0.8f);
+        typeTag = tag();
     }
 
     Platform5D(const Vec5D& pos, const Vec5D& sz) : Platform5D() {
-        position = pos;
-        size = sz;
+        position() = pos;
+        size() = sz;
+    }
+
+    void describe(EntityDesc5D& desc) const override {
+        if (isStatic) desc.archetype = EntityDesc5D::Platform;
     }
 };
 
@@ -123,23 +456,149 @@ class Goal5D : public GameObject5D {
 public:
     bool activated;
 
+    static int tag() {
+        static const int type = ObjectType5D::intern("Goal");
+        return type;
+    }
+
     Goal5D() : activated(false) {
         isStatic = true;
         isSolid = false;
-        color = glm::vec3(0.2f, 1.0f, 0.3f);
-        name = "Goal";
-        size = Vec5D(1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+        isTrigger = true;
+        color() = glm::vec3(0.2f, 1.0f, 0.3f);
+        typeTag = tag();
+        size() = Vec5D(1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+        lightIntensity() = 1.5f;
+        lightRadius() = 6.0f;
     }
 
     Goal5D(const Vec5D& pos) : Goal5D() {
-        position = pos;
+        position() = pos;
+    }
+
+    int saveCustomState(float* out) const override {
+        out[0] = activated ? 1.0f : 0.0f;
+        return 1;
+    }
+
+    void loadCustomState(const float* in) override {
+        activated = in[0] != 0.0f;
     }
 
-    void update(float deltaTime) override {
+    void describe(EntityDesc5D& desc) const override {
         // Pulsating effect
-        static float time = 0.0f;
-        time += deltaTime;
-        opacity = 0.7f + 0.3f * std::sin(time * 3.0f);
+        desc.archetype = EntityDesc5D::Pulser;
+        desc.pulseRate = 3.0f;
+        desc.pulseBase = 0.7f;
+        desc.pulseAmplitude = 0.3f;
+    }
+};
+
+/**
+ * Checkpoint5D - Touching it moves the player's respawn point here
+ */
+class Checkpoint5D : public GameObject5D {
+public:
+    bool activated;
+
+    static int tag() {
+        static const int type = ObjectType5D::intern("Checkpoint");
+        return type;
+    }
+
+    Checkpoint5D() : activated(false) {
+        isStatic = true;
+        isSolid = false;
+        isTrigger = true;
+        color() = glm::vec3(0.9f, 0.8f, 0.2f);
+        opacity() = 0.5f;
+        typeTag = tag();
+        size() = Vec5D(1.0f, 2.0f, 1.0f, 1.0f, 1.0f);
+    }
+
+    Checkpoint5D(const Vec5D& pos) : Checkpoint5D() {
+        position() = pos;
+    }
+
+    int saveCustomState(float* out) const override {
+        out[0] = activated ? 1.0f : 0.0f;
+        return 1;
+    }
+
+    void loadCustomState(const float* in) override {
+        activated = in[0] != 0.0f;
+    }
+
+    void activate() {
+        activated = true;
+        opacity() = 0.9f;
+        lightIntensity() = 1.0f;
+        lightRadius() = 4.0f;
+    }
+};
+
+/**
+ * DamageZone5D - Entering it sends the player back to the last checkpoint
+ */
+class DamageZone5D : public GameObject5D {
+public:
+    static int tag() {
+        static const int type = ObjectType5D::intern("DamageZone");
+        return type;
+    }
+
+    DamageZone5D(const Vec5D& pos, const Vec5D& sz) {
+        position() = pos;
+        size() = sz;
+        isStatic = true;
+        isSolid = false;
+        isTrigger = true;
+        color() = glm::vec3(0.9f, 0.1f, 0.1f);
+        opacity() = 0.3f;
+        typeTag = tag();
+    }
+};
+
+/**
+ * Portal5D - One end of a linked portal pair
+ * 
+ * Portals are solid pads. Stepping onto one moves the player by the offset
+ * to the linked portal, which may be far away in hidden dimensions. The
+ * renderer draws each portal as a window onto its linked endpoint.
+ */
+class Portal5D : public Platform5D {
+public:
+    // Collision resolution keeps the player just outside the pad, so
+    // touching is tested against a slightly inflated box
+    static constexpr float TouchMargin = 0.05f;
+
+    Portal5D* linked;         // Other end of the pair (not owned)
+
+    static int tag() {
+        static const int type = ObjectType5D::intern("Portal");
+        return type;
+    }
+
+    Portal5D(const Vec5D& pos, const Vec5D& sz, const glm::vec3& col)
+        : Platform5D(pos, sz)
+        , linked(nullptr)
+    {
+        color() = col;
+        opacity() = 0.7f;
+        typeTag = tag();
+        isTrigger = true;
+    }
+
+    void describe(EntityDesc5D& desc) const override {
+        // Drawn as windows by the renderer, so kept out of the platform table
+        (void)desc;
+    }
+
+    /**
+     * Translation that carries a point at this portal to the linked one
+     */
+    Vec5D linkOffset() const {
+        return linked ? linked->position() - position() : Vec5D();
     }
 };
 
@@ -150,18 +609,19 @@ class MovingPlatform5D : public Platform5D {
 public:
     Vec5D startPos;
     Vec5D endPos;
-    float speed;
-    float progress;
-    bool movingForward;
+    float speed;              // Start-to-end trips per second; progress lives in the entity store
+
+    static int tag() {
+        static const int type = ObjectType5D::intern("MovingPlatform");
+        return type;
+    }
 
     MovingPlatform5D() 
         : speed(1.0f)
-        , progress(0.0f)
-        , movingForward(true)
     {
         isStatic = false;
-        name = "MovingPlatform";
-        color = glm::vec3(0.8f, 0.6f, 0.9f);
+        typeTag = tag();
+        color() = glm::vec3(0.8f, 0.6f, 0.9f);
     }
 
     MovingPlatform5D(const Vec5D& start, const Vec5D& end, float spd)
@@ -169,31 +629,33 @@ public:
     {
         startPos = start;
         endPos = end;
-        position = start;
+        position() = start;
         speed = spd;
     }
 
-    void update(float deltaTime) override {
-        // Move between start and end positions
-        if (movingForward) {
-            progress += speed * deltaTime;
-            if (progress >= 1.0f) {
-                progress = 1.0f;
-                movingForward = false;
-            }
-        } else {
-            progress -= speed * deltaTime;
-            if (progress <= 0.0f) {
-                progress = 0.0f;
-                movingForward = true;
-            }
+    void describe(EntityDesc5D& desc) const override {
+        // Moves back and forth between start and end positions
+        desc.archetype = EntityDesc5D::Mover;
+        desc.pathStart = startPos;
+        desc.pathEnd = endPos;
+        desc.pathSpeed = speed;
+    }
+
+    // Scripts retune and reverse paths mid-level
+    int saveCustomState(float* out) const override {
+        for (int i = 0; i < 5; ++i) {
+            out[i] = startPos[i];
+            out[5 + i] = endPos[i];
         }
+        out[10] = speed;
+        return 11;
+    }
 
-        // Smooth interpolation
-        float t = progress * progress * (3.0f - 2.0f * progress);
-        position = startPos + (endPos - startPos) * t;
-        
-        // Calculate velocity for proper physics interaction
-        velocity = (endPos - startPos) * speed * (movingForward ? 1.0f : -1.0f);
+    void loadCustomState(const float* in) override {
+        for (int i = 0; i < 5; ++i) {
+            startPos[i] = in[i];
+            endPos[i] = in[5 + i];
+        }
+        speed = in[10];
     }
 };
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Handle5D - Generational reference to a slot in a table
+ *
+ * The index picks the slot and the generation must match the slot's, which
+ * goes up whenever the slot is freed. A handle to something that has gone
+ * away therefore stays dead even after its slot is reused. Object pools,
+ * the timer wheel and a level's object table all hand these out.
+ */
+struct Handle5D {
+    static constexpr uint32_t InvalidIndex = 0xffffffffu;
+
+    uint32_t index;
+    uint32_t generation;
+
+    Handle5D() : index(InvalidIndex), generation(0) {}
+    Handle5D(uint32_t i, uint32_t g) : index(i), generation(g) {}
+
+    bool isValid() const {
+        return index != InvalidIndex;
+    }
+
+    bool operator==(const Handle5D& other) const {
+        return index == other.index && generation == other.generation;
+    }
+};
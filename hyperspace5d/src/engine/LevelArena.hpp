@@ -0,0 +1,111 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * LevelArena - Monotonic memory for objects that live as long as a level
+ *
+ * Allocation bumps an offset through a list of blocks; deallocation does
+ * nothing. release() frees everything in one step by rewinding to the
+ * first block, so the objects in it must already be destroyed.
+ *
+ * Blocks are kept across releases. If a load needed more than one block,
+ * release() merges them into one block the size of everything used, so
+ * loading the same level again fits in a single block and doesn't touch
+ * the heap.
+ */
+class LevelArena : public std::pmr::memory_resource {
+public:
+    explicit LevelArena(size_t bytes = 64 * 1024)
+        : current(0)
+        , offset(0)
+        , used(0)
+    {
+        blocks.push_back(Block(bytes));
+    }
+
+    LevelArena(const LevelArena&) = delete;
+    LevelArena& operator=(const LevelArena&) = delete;
+
+    /**
+     * Free every allocation at once.
+     */
+    void release() {
+        if (current > 0) {
+            size_t total = 0;
+            for (const Block& block : blocks) {
+                total += block.size;
+            }
+            blocks.clear();
+            blocks.push_back(Block(std::max(total, used)));
+        }
+        current = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    size_t getUsed() const {
+        return used;
+    }
+
+    size_t getCapacity() const {
+        size_t total = 0;
+        for (const Block& block : blocks) {
+            total += block.size;
+        }
+        return total;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        while (true) {
+            Block& block = blocks[current];
+            size_t start = (offset + alignment - 1) & ~(alignment - 1);
+            if (start + bytes <= block.size) {
+                offset = start + bytes;
+                used += bytes;
+                return block.memory.get() + start;
+            }
+            ++current;
+            offset = 0;
+            if (current == blocks.size()) {
+                blocks.push_back(Block(std::max(block.size * 2, bytes + alignment)));
+            }
+        }
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr size_t BlockAlignment = 64;
+
+    struct AlignedDelete {
+        void operator()(unsigned char* memory) const {
+            ::operator delete[](memory, std::align_val_t(BlockAlignment));
+        }
+    };
+
+    struct Block {
+        std::unique_ptr<unsigned char[], AlignedDelete> memory;
+        size_t size;
+
+        explicit Block(size_t bytes)
+            : memory(static_cast<unsigned char*>(::operator new[](bytes, std::align_val_t(BlockAlignment))))
+            , size(bytes)
+        {}
+    };
+
+    std::vector<Block> blocks;
+    size_t current;                 // Block being bumped through
+    size_t offset;                  // Next free byte in it
+    size_t used;                    // Bytes handed out since release()
+};
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include "EntityStore5D.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * ObjectState5D - One object's entry in a level snapshot
+ *
+ * Plain data: the fields play changes on any object, the object's entity
+ * row, and where its custom state (GameObject5D::saveCustomState) sits in
+ * the snapshot's float array.
+ */
+struct ObjectState5D {
+    static constexpr uint8_t Static = 1;
+    static constexpr uint8_t Solid = 2;
+    static constexpr uint8_t Awake = 4;
+    static constexpr uint8_t Visible = 8;
+
+    GameObject5D* object;     // Identity check only; never dereferenced unchecked
+    Handle5D handle;
+    Vec5D position;
+    Vec5D velocity;
+    Vec5D size;
+    Vec5D previousPosition;
+    glm::vec3 color;
+    float opacity;
+    float lightIntensity;
+    float lightRadius;
+    float restTime;
+    float inverseMass;
+    EntityStore5D::RowState row;
+    uint32_t customOffset;
+    uint8_t customCount;
+    uint8_t flags;
+    bool hasRow;              // Had an entity row when captured
+};
+
+/**
+ * LevelSnapshot5D - A level's state as flat arrays, for instant restarts
+ *
+ * Captured right after a level loads (Level::captureSnapshot). Restoring
+ * copies the arrays back onto the same objects instead of rebuilding them,
+ * so it needs every captured object to still be in the level; objects
+ * spawned since are discarded. Level::restoreSnapshot says when it can't
+ * restore and the level has to be reloaded instead.
+ *
+ * The arrays keep their capacity, so capturing the same level again
+ * doesn't allocate. writeValues()/readValues() flatten the changing part
+ * to floats for the rewind history.
+ */
+struct LevelSnapshot5D {
+    static constexpr int MaxScriptState = 16;
+    static constexpr size_t ObjectValues = 28;  // Per object in writeValues(), besides custom state
+
+    std::vector<ObjectState5D> objects;     // In level object order
+    std::vector<float> custom;              // Objects' custom state, back to back
+    std::vector<int> active;                // Active set as indices into objects, in order
+    float script[MaxScriptState];           // Level script variables (Level::saveScriptState)
+    int scriptCount;
+    Vec5D respawnPos;
+    int nextObjectId;
+    bool valid;                             // False if the state couldn't be captured
+
+    LevelSnapshot5D()
+        : scriptCount(0)
+        , nextObjectId(1)
+        , valid(false)
+    {}
+
+    void clear() {
+        objects.clear();
+        custom.clear();
+        active.clear();
+        scriptCount = 0;
+        valid = false;
+    }
+
+    size_t memoryBytes() const {
+        return objects.size() * sizeof(ObjectState5D) + custom.size() * sizeof(float) +
+               active.size() * sizeof(int);
+    }
+
+    /**
+     * Append the state of the first objectCount objects, the script
+     * variables and the respawn point to out as floats, for the rewind
+     * buffer. Only what play can change is written; which objects there
+     * are and where their custom state goes comes from the snapshot
+     * readValues() is called on. The first objectCount values say where
+     * each object is in the active set, or -1.
+     */
+    void writeValues(size_t objectCount, std::vector<float>& out) const {
+        objectCount = std::min(objectCount, objects.size());
+        size_t count = objectCount * (ObjectValues + 1) + scriptCount + 6;
+        for (size_t i = 0; i < objectCount; ++i) {
+            count += objects[i].customCount;
+        }
+        size_t start = out.size();
+        out.resize(start + count);
+        float* slots = out.data() + start;
+        float* o = slots + objectCount;
+
+        std::fill(slots, o, -1.0f);
+        for (size_t i = 0; i < active.size(); ++i) {
+            if (static_cast<size_t>(active[i]) < objectCount) {
+                slots[active[i]] = static_cast<float>(i);
+            }
+        }
+
+        for (size_t i = 0; i < objectCount; ++i) {
+            const ObjectState5D& state = objects[i];
+            for (int d = 0; d < 5; ++d) *o++ = state.position[d];
+            for (int d = 0; d < 5; ++d) *o++ = state.velocity[d];
+            for (int d = 0; d < 5; ++d) *o++ = state.size[d];
+            *o++ = state.color.r;
+            *o++ = state.color.g;
+            *o++ = state.color.b;
+            *o++ = state.opacity;
+            *o++ = state.lightIntensity;
+            *o++ = state.lightRadius;
+            *o++ = state.restTime;
+            *o++ = state.flags;
+            *o++ = state.hasRow ? 1.0f : 0.0f;
+            *o++ = state.row.pathProgress;
+            *o++ = state.row.pulseTime;
+            *o++ = state.row.age;
+            *o++ = state.row.pathForward;
+            o = std::copy(custom.begin() + state.customOffset,
+                          custom.begin() + state.customOffset + state.customCount, o);
+        }
+
+        o = std::copy(script, script + scriptCount, o);
+        for (int d = 0; d < 5; ++d) *o++ = respawnPos[d];
+        *o++ = static_cast<float>(nextObjectId);
+    }
+
+    /**
+     * Load values written by writeValues() over this snapshot's objects.
+     * Returns how many were read. Previous positions are set to the
+     * positions, so nothing interpolates across the jump.
+     */
+    size_t readValues(std::span<const float> values) {
+        size_t objectCount = objects.size();
+        const float* slots = values.data();
+        const float* in = slots + objectCount;
+
+        active.clear();
+        for (size_t i = 0; i < objectCount; ++i) {
+            ObjectState5D& state = objects[i];
+            for (int d = 0; d < 5; ++d) state.position[d] = *in++;
+            for (int d = 0; d < 5; ++d) state.velocity[d] = *in++;
+            for (int d = 0; d < 5; ++d) state.size[d] = *in++;
+            state.previousPosition = state.position;
+            state.color.r = *in++;
+            state.color.g = *in++;
+            state.color.b = *in++;
+            state.opacity = *in++;
+            state.lightIntensity = *in++;
+            state.lightRadius = *in++;
+            state.restTime = *in++;
+            state.flags = static_cast<uint8_t>(*in++);
+            state.hasRow = *in++ != 0.0f;
+            state.row.pathProgress = *in++;
+            state.row.pulseTime = *in++;
+            state.row.age = *in++;
+            state.row.pathForward = static_cast<uint8_t>(*in++);
+            std::copy(in, in + state.customCount, custom.begin() + state.customOffset);
+            in += state.customCount;
+
+            if (slots[i] >= 0.0f) active.push_back(static_cast<int>(i));
+        }
+        std::sort(active.begin(), active.end(), [slots](int a, int b) {
+            return slots[a] < slots[b];
+        });
+
+        std::copy(in, in + scriptCount, script);
+        in += scriptCount;
+        for (int d = 0; d < 5; ++d) respawnPos[d] = *in++;
+        nextObjectId = static_cast<int>(*in++);
+        return static_cast<size_t>(in - values.data());
+    }
+};
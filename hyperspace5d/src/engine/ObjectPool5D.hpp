@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Handle5D.hpp"
+#include <memory>
+#include <vector>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * ObjectPool5D - Fixed number of objects of one type, allocated up front
+ *
+ * Objects are constructed in place in preallocated slots, so creating and
+ * destroying them never touches the heap. Free slots are kept on a free
+ * list. Live objects are also listed densely for iteration; destroying one
+ * moves the last entry into its place.
+ *
+ * Handles (Handle5D) carry the slot's generation, which goes up every
+ * time the slot is freed, so a handle to a destroyed object resolves to
+ * nullptr instead of whatever reuses the slot.
+ */
+template<typename T>
+class ObjectPool5D {
+public:
+    explicit ObjectPool5D(int capacity)
+        : slots(new Slot[capacity])
+        , slotCount(capacity)
+    {
+        freeSlots.reserve(capacity);
+        live.reserve(capacity);
+        for (int i = capacity - 1; i >= 0; --i) {
+            freeSlots.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    ~ObjectPool5D() {
+        clear();
+    }
+
+    ObjectPool5D(const ObjectPool5D&) = delete;
+    ObjectPool5D& operator=(const ObjectPool5D&) = delete;
+
+    /**
+     * Construct an object in a free slot. Returns an invalid handle if the
+     * pool is full.
+     */
+    template<typename... Args>
+    Handle5D create(Args&&... args) {
+        if (freeSlots.empty()) return Handle5D();
+        uint32_t index = freeSlots.back();
+        freeSlots.pop_back();
+
+        Slot& slot = slots[index];
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.alive = true;
+        slot.liveIndex = static_cast<uint32_t>(live.size());
+        live.push_back(index);
+        return Handle5D(index, slot.generation);
+    }
+
+    /**
+     * Destroy the object a handle refers to; stale handles are ignored.
+     */
+    void destroy(Handle5D handle) {
+        if (!get(handle)) return;
+        Slot& slot = slots[handle.index];
+        object(slot)->~T();
+        slot.alive = false;
+        ++slot.generation;
+
+        uint32_t moved = live.back();
+        live[slot.liveIndex] = moved;
+        slots[moved].liveIndex = slot.liveIndex;
+        live.pop_back();
+        freeSlots.push_back(handle.index);
+    }
+
+    /**
+     * Object a handle refers to, or nullptr if it has been destroyed.
+     */
+    T* get(Handle5D handle) const {
+        if (handle.index >= slotCount) return nullptr;
+        const Slot& slot = slots[handle.index];
+        if (!slot.alive || slot.generation != handle.generation) return nullptr;
+        return object(slot);
+    }
+
+    void clear() {
+        while (!live.empty()) {
+            destroy(handleAt(static_cast<int>(live.size()) - 1));
+        }
+    }
+
+    /**
+     * Live objects are numbered 0..size()-1 in no particular order.
+     * Destroying one renumbers the last.
+     */
+    int size() const {
+        return static_cast<int>(live.size());
+    }
+
+    int capacity() const {
+        return static_cast<int>(slotCount);
+    }
+
+    Handle5D handleAt(int i) const {
+        uint32_t index = live[i];
+        return Handle5D(index, slots[index].generation);
+    }
+
+    T* at(int i) const {
+        return object(slots[live[i]]);
+    }
+
+    /**
+     * Handle of a live object from this pool. Anything else (an object from
+     * elsewhere, or one already destroyed) gets an invalid handle.
+     */
+    Handle5D handleOf(const T* obj) const {
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(obj);
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(slots.get());
+        if (address < base || address >= base + slotCount * sizeof(Slot)) return Handle5D();
+        std::uintptr_t offset = address - base;
+        if (offset % sizeof(Slot) != offsetof(Slot, storage)) return Handle5D();
+
+        uint32_t index = static_cast<uint32_t>(offset / sizeof(Slot));
+        if (!slots[index].alive) return Handle5D();
+        return Handle5D(index, slots[index].generation);
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation;
+        uint32_t liveIndex;
+        bool alive;
+
+        Slot() : generation(0), liveIndex(0), alive(false) {}
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    uint32_t slotCount;
+    std::vector<uint32_t> freeSlots;
+    std::vector<uint32_t> live;     // Slot of each live object
+
+    static T* object(const Slot& slot) {
+        return std::launder(reinterpret_cast<T*>(const_cast<unsigned char*>(slot.storage)));
+    }
+};
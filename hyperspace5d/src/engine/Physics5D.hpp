@@ -2,8 +2,16 @@
 
 #include "GameObject5D.hpp"
 #include "Player5D.hpp"
+#include "SweepAndPrune5D.hpp"
+#include "SpatialHash5D.hpp"
+#include "BVH5D.hpp"
 #include <vector>
 #include <memory>
+#include <span>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
 
 /**
  * Physics5D - Physics engine for 5D space
@@ -13,53 +21,87 @@
  */
 class Physics5D {
 public:
+    // Distance within which boxes count as touching rather than overlapping
+    static constexpr float ContactSlop = 1e-4f;
+
     struct CollisionInfo {
         GameObject5D* object;
         Vec5D normal;           // Collision normal in 5D space
         float penetration;      // How far objects overlap
         int collisionDim;       // Primary dimension of collision
+        int instanceA;          // Which box of each object touches (multi-box
+        int instanceB;          // objects such as echo trails have several)
         
-        CollisionInfo() : object(nullptr), penetration(0.0f), collisionDim(0) {}
+        CollisionInfo() : object(nullptr), penetration(0.0f), collisionDim(0), instanceA(0), instanceB(0) {}
     };
 
     /**
-     * Check collision between two objects
+     * Check collision between two objects: one manifold per pair of their
+     * boxes that touch, so an object resting across two echoes of a trail
+     * gets a contact with each. Boxes up to margin apart count as
+     * colliding, with a negative penetration. Writes at most maxContacts
+     * manifolds, keeping the deepest, and returns how many it wrote.
      */
-    static bool checkCollision(const GameObject5D& a, const GameObject5D& b, CollisionInfo* info = nullptr) {
-        if (!a.intersects(b)) {
-            return false;
-        }
+    static int checkCollision(const GameObject5D& a, const GameObject5D& b, CollisionInfo* contacts,
+                              int maxContacts, float margin = 0.0f) {
+        int count = 0;
+        for (int instanceA = 0; instanceA < a.instanceCount(); ++instanceA) {
+            Vec5D centerA = a.instancePosition(instanceA);
+            for (int instanceB = 0; instanceB < b.instanceCount(); ++instanceB) {
+                CollisionInfo contact;
+                if (!checkBoxes(centerA, a.size(), b.instancePosition(instanceB), b.size(), margin, contact)) continue;
+                contact.instanceA = instanceA;
+                contact.instanceB = instanceB;
 
-        if (info) {
-            // Calculate collision details
-            Vec5D centerA = a.position;
-            Vec5D centerB = b.position;
-            Vec5D diff = centerA - centerB;
-            
-            // Find the dimension with minimum penetration (that's the collision axis)
-            float minPenetration = std::numeric_limits<float>::max();
-            int collisionDim = 0;
-            
-            for (int i = 0; i < 5; ++i) {
-                float halfSizeA = a.size[i] * 0.5f;
-                float halfSizeB = b.size[i] * 0.5f;
-                float penetration = (halfSizeA + halfSizeB) - std::abs(diff[i]);
-                
-                if (penetration < minPenetration) {
-                    minPenetration = penetration;
-                    collisionDim = i;
+                if (count < maxContacts) {
+                    contacts[count++] = contact;
+                    continue;
                 }
+                // Full: the deepest contacts matter most to the solver
+                int shallowest = 0;
+                for (int i = 1; i < count; ++i) {
+                    if (contacts[i].penetration < contacts[shallowest].penetration) shallowest = i;
+                }
+                if (contact.penetration > contacts[shallowest].penetration) contacts[shallowest] = contact;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Check collision between two boxes. On overlap, info gets the normal
+     * (pointing from B to A) along the axis of least penetration.
+     */
+    static bool checkBoxes(const Vec5D& centerA, const Vec5D& sizeA, const Vec5D& centerB, const Vec5D& sizeB,
+                           float margin, CollisionInfo& info) {
+        Vec5D diff = centerA - centerB;
+
+        for (int i = 0; i < 5; ++i) {
+            if (std::abs(diff[i]) > (sizeA[i] + sizeB[i]) * 0.5f + margin) {
+                return false;  // No overlap in this dimension
             }
-            
-            // Create normal vector pointing from B to A
-            Vec5D normal;
-            normal[collisionDim] = (diff[collisionDim] > 0) ? 1.0f : -1.0f;
-            
-            info->normal = normal;
-            info->penetration = minPenetration;
-            info->collisionDim = collisionDim;
         }
 
+        // Find the dimension with minimum penetration (that's the collision axis)
+        float minPenetration = std::numeric_limits<float>::max();
+        int collisionDim = 0;
+        
+        for (int i = 0; i < 5; ++i) {
+            float penetration = (sizeA[i] + sizeB[i]) * 0.5f - std::abs(diff[i]);
+            
+            if (penetration < minPenetration) {
+                minPenetration = penetration;
+                collisionDim = i;
+            }
+        }
+        
+        // Create normal vector pointing from B to A
+        Vec5D normal;
+        normal[collisionDim] = (diff[collisionDim] > 0) ? 1.0f : -1.0f;
+        
+        info.normal = normal;
+        info.penetration = minPenetration;
+        info.collisionDim = collisionDim;
         return true;
     }
 
@@ -70,7 +112,8 @@ public:
         if (!object.isSolid) return;
 
         // Push player out of the object
-        player.position += collision.normal * collision.penetration;
+        player.position() += collision.normal * collision.penetration;
+        player.updateBounds();
         
         // Check if this is a ground collision (in the "up" dimension)
         if (player.dimState) {
@@ -80,10 +123,10 @@ public:
                 if (collision.normal[upDim] > 0) {
                     // Collision from below (standing on ground)
                     player.isGrounded = true;
-                    player.velocity[upDim] = std::max(0.0f, player.velocity[upDim]);
+                    player.velocity()[upDim] = std::max(0.0f, player.velocity()[upDim]);
                 } else {
                     // Collision from above (hit ceiling)
-                    player.velocity[upDim] = std::min(0.0f, player.velocity[upDim]);
+                    player.velocity()[upDim] = std::min(0.0f, player.velocity()[upDim]);
                 }
             } else {
                 // Wall collision
@@ -91,103 +134,195 @@ public:
                 player.wallNormal = collision.normal;
                 
                 // Stop velocity in collision direction
-                float velocityInNormal = player.velocity.dot(collision.normal);
+                float velocityInNormal = player.velocity().dot(collision.normal);
                 if (velocityInNormal < 0) {
-                    player.velocity -= collision.normal * velocityInNormal;
+                    player.velocity() -= collision.normal * velocityInNormal;
                 }
             }
         }
     }
 
     /**
-     * Apply physics to player and check collisions
+     * Apply physics to player with continuous collision.
+     *
+     * The step's motion is swept against everything the player's swept box
+     * touches: static objects from the BVH, moving objects the broadphase
+     * reports for the player's proxy, and transient objects from the
+     * spatial hash. Velocity response, contact flags and any remaining
+     * overlap (an object that moved into the player) are left to the
+     * contact solver once the frame's contacts are known.
      */
-    static void updatePlayer(Player5D& player, const std::vector<std::shared_ptr<GameObject5D>>& objects, float deltaTime) {
+    void updatePlayer(Player5D& player, const BVH5D& staticIndex, SweepAndPrune5D& broadphase,
+                      int playerProxy, float deltaTime, const SpatialHash5D* transientIndex = nullptr) {
         // Reset collision flags
         player.isGrounded = false;
         player.isOnWall = false;
         
-        // Store old position for collision response
-        Vec5D oldPos = player.position;
-        
-        // Update player (applies velocity)
+        // Update player (applies velocity), then rewind to sweep the motion
+        Vec5D start = player.position();
         player.update(deltaTime);
+        Vec5D motion = player.position() - start;
+        player.position() = start;
+        player.updateBounds();
         
-        // Check collisions with all objects
-        for (auto& obj : objects) {
-            if (obj.get() == &player) continue;
-            if (!obj->isSolid) continue;
+        // Box covering the whole step
+        Vec5D sweptMin, sweptMax;
+        player.getBounds(sweptMin, sweptMax);
+        for (int i = 0; i < 5; ++i) {
+            if (motion[i] > 0.0f) sweptMax[i] += motion[i];
+            else sweptMin[i] += motion[i];
+        }
+        broadphase.updateProxy(playerProxy, sweptMin, sweptMax);
+        
+        // Gather candidates
+        candidates.clear();
+        auto addCandidate = [&](GameObject5D* obj) {
+            if (obj->isSolid) candidates.push_back(obj);
+        };
+        staticIndex.queryBox(sweptMin, sweptMax, addCandidate);
+        for (int other : broadphase.overlaps(playerProxy)) {
+            addCandidate(broadphase.object(other));
+        }
+        if (transientIndex) {
+            transientIndex->queryBox(sweptMin, sweptMax, addCandidate);
+        }
+        
+        sweepPlayer(player, motion, candidates);
+        player.updateBounds();
+    }
+
+    /**
+     * Move the player by motion, stopping at the first contact and sliding
+     * along it. Every contact removes the motion along one axis, so five
+     * iterations always use it up. Only position changes here.
+     */
+    static void sweepPlayer(Player5D& player, Vec5D motion, std::span<GameObject5D* const> candidates) {
+        for (int iteration = 0; iteration < 5; ++iteration) {
+            float firstHit = 1.0f;
+            int hitDim = -1;
+            GameObject5D* hitObject = nullptr;
+            
+            for (GameObject5D* obj : candidates) {
+                for (int instance = 0; instance < obj->instanceCount(); ++instance) {
+                    float toi;
+                    int dim;
+                    if (sweepBox(player.position(), player.size(), motion,
+                                 obj->instancePosition(instance), obj->size(), &toi, &dim) &&
+                        toi < firstHit) {
+                        firstHit = toi;
+                        hitDim = dim;
+                        hitObject = obj;
+                    }
+                }
+            }
             
-            CollisionInfo collision;
-            if (checkCollision(player, *obj, &collision)) {
-                collision.object = obj.get();
-                resolvePlayerCollision(player, *obj, collision);
+            if (!hitObject) {
+                player.position() += motion;
+                return;
             }
+            
+            // Move up to the contact
+            player.position() += motion * firstHit;
+            
+            // Slide: keep the rest of the motion minus the blocked axis
+            motion = motion * (1.0f - firstHit);
+            motion[hitDim] = 0.0f;
         }
     }
 
     /**
-     * Cast a ray through 5D space
-     * Used for visibility checks and advanced collision detection
+     * Time of impact of a moving box against a fixed one (swept AABB).
+     *
+     * The fixed box is grown by the moving box's half size, turning the
+     * problem into a ray (the moving center) against a box. On a hit,
+     * *toi is the fraction of motion before contact and *hitDim the axis
+     * of the face hit. Boxes that only touch, or already overlap deeper
+     * than ContactSlop, don't count; overlap is left to checkCollision.
      */
-    static bool rayCast(const Vec5D& origin, const Vec5D& direction, float maxDistance,
-                       const std::vector<std::shared_ptr<GameObject5D>>& objects,
-                       GameObject5D** hitObject, Vec5D* hitPoint) {
+    static bool sweepBox(const Vec5D& center, const Vec5D& size, const Vec5D& motion,
+                         const Vec5D& otherCenter, const Vec5D& otherSize, float* toi, int* hitDim) {
+        float tNear = -std::numeric_limits<float>::max();
+        float tFar = std::numeric_limits<float>::max();
+        int entryDim = -1;
         
-        float closestDistance = maxDistance;
-        GameObject5D* closest = nullptr;
-        Vec5D closestPoint;
-        
-        for (auto& obj : objects) {
-            if (!obj->isSolid) continue;
-            
-            // Simplified ray-box intersection in 5D
-            // For each dimension, calculate entry and exit times
-            float tMin = 0.0f;
-            float tMax = maxDistance;
+        for (int i = 0; i < 5; ++i) {
+            float reach = (size[i] + otherSize[i]) * 0.5f;
+            float lo = otherCenter[i] - reach;
+            float hi = otherCenter[i] + reach;
             
-            Vec5D objMin = obj->getMin();
-            Vec5D objMax = obj->getMax();
-            
-            for (int i = 0; i < 5; ++i) {
-                if (std::abs(direction[i]) > 1e-6f) {
-                    float t1 = (objMin[i] - origin[i]) / direction[i];
-                    float t2 = (objMax[i] - origin[i]) / direction[i];
-                    
-                    if (t1 > t2) std::swap(t1, t2);
-                    
-                    tMin = std::max(tMin, t1);
-                    tMax = std::min(tMax, t2);
-                    
-                    if (tMin > tMax) break;
-                }
+            if (std::abs(motion[i]) < 1e-8f) {
+                // Not moving on this axis: must already be strictly inside the slab
+                if (center[i] <= lo + ContactSlop || center[i] >= hi - ContactSlop) return false;
+                continue;
             }
             
-            if (tMin <= tMax && tMin < closestDistance && tMin >= 0) {
-                closestDistance = tMin;
-                closest = obj.get();
-                closestPoint = origin + direction * tMin;
+            float invMotion = 1.0f / motion[i];
+            float t1 = (lo - center[i]) * invMotion;
+            float t2 = (hi - center[i]) * invMotion;
+            float entry = std::min(t1, t2);
+            if (entry > tNear) {
+                tNear = entry;
+                entryDim = i;
             }
+            tFar = std::min(tFar, std::max(t1, t2));
+        }
+        
+        if (entryDim < 0 || tNear >= tFar || tNear > 1.0f) return false;
+        
+        // Entered before the step started: only a contact if within the slop
+        if (tNear * std::abs(motion[entryDim]) < -ContactSlop) return false;
+        
+        *toi = std::max(tNear, 0.0f);
+        *hitDim = entryDim;
+        return true;
+    }
+
+    /**
+     * Cast a ray against the static geometry in a BVH
+     */
+    static bool rayCast(const Vec5D& origin, const Vec5D& direction, float maxDistance,
+                        const BVH5D& staticIndex, GameObject5D** hitObject, Vec5D* hitPoint) {
+        float distance;
+        if (!staticIndex.rayCast(origin, direction, maxDistance, hitObject, &distance)) {
+            return false;
         }
+        if (hitPoint) *hitPoint = origin + direction * distance;
+        return true;
+    }
+
+    /**
+     * Cast every ray of a batch against the static geometry in a BVH,
+     * RayBatch5D::Lanes rays at a time
+     */
+    static void rayCast(RayBatch5D& batch, const BVH5D& staticIndex) {
+        auto start = std::chrono::steady_clock::now();
         
-        if (closest) {
-            if (hitObject) *hitObject = closest;
-            if (hitPoint) *hitPoint = closestPoint;
-            return true;
+        RayPacket5D packet;
+        for (int first = 0; first < batch.size(); first += RayBatch5D::Lanes) {
+            packet.load(batch, first);
+            staticIndex.rayCastPacket(packet);
+            packet.store(batch);
         }
         
-        return false;
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        batch.lastQueryMs = elapsed.count();
     }
 
     /**
-     * Check if a point is inside any solid object
+     * Check if a point is inside any solid static object in a BVH
      */
-    static bool pointInSolid(const Vec5D& point, const std::vector<std::shared_ptr<GameObject5D>>& objects) {
-        for (const auto& obj : objects) {
+    static bool pointInSolid(const Vec5D& point, const BVH5D& staticIndex) {
+        bool inside = false;
+        staticIndex.queryPoint(point, [&](GameObject5D* obj) {
             if (obj->isSolid && obj->contains(point)) {
-                return true;
+                inside = true;
             }
-        }
-        return false;
+        });
+        return inside;
     }
+
+private:
+    // Objects the player's swept box reaches this step; kept between
+    // steps so they don't allocate
+    std::vector<GameObject5D*> candidates;
 };
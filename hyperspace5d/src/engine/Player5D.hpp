@@ -39,6 +39,11 @@ public:
     // Reference to dimension state (not owned)
     const DimensionState* dimState;
 
+    static int tag() {
+        static const int type = ObjectType5D::intern("Player");
+        return type;
+    }
+
     Player5D() 
         : moveSpeed(5.0f)
         , jumpStrength(8.0f)
@@ -59,15 +64,39 @@ public:
         , dashPressed(false)
         , dimState(nullptr)
     {
-        name = "Player";
-        color = glm::vec3(0.3f, 0.6f, 1.0f);
-        size = Vec5D(0.8f, 1.6f, 0.8f, 0.8f, 0.8f);
+        typeTag = tag();
+        color() = glm::vec3(0.3f, 0.6f, 1.0f);
+        size() = Vec5D(0.8f, 1.6f, 0.8f, 0.8f, 0.8f);
+        inverseMass = 1.0f;
+        isAwake = true;
     }
 
     void setDimensionState(const DimensionState* state) {
         dimState = state;
     }
 
+    // Movement state, for rewinding; input isn't kept
+    int saveCustomState(float* out) const override {
+        out[0] = isGrounded ? 1.0f : 0.0f;
+        out[1] = isOnWall ? 1.0f : 0.0f;
+        out[2] = isDashing ? 1.0f : 0.0f;
+        out[3] = canDash ? 1.0f : 0.0f;
+        out[4] = dashTimer;
+        out[5] = dashCooldownTimer;
+        for (int i = 0; i < 5; ++i) out[6 + i] = wallNormal[i];
+        return 11;
+    }
+
+    void loadCustomState(const float* in) override {
+        isGrounded = in[0] != 0.0f;
+        isOnWall = in[1] != 0.0f;
+        isDashing = in[2] != 0.0f;
+        canDash = in[3] != 0.0f;
+        dashTimer = in[4];
+        dashCooldownTimer = in[5];
+        for (int i = 0; i < 5; ++i) wallNormal[i] = in[6 + i];
+    }
+
     void update(float deltaTime) override {
         // Update timers
         if (dashCooldownTimer > 0.0f) {
@@ -93,11 +122,11 @@ public:
             // Apply jump velocity in the "up" direction of current view
             if (dimState) {
                 int upDim = dimState->visibleDims[1];  // Y axis of current view
-                velocity[upDim] = jumpStrength;
+                velocity()[upDim] = jumpStrength;
                 
                 // Wall jump: also push away from wall
                 if (isOnWall && !isGrounded) {
-                    velocity = velocity + wallNormal * (jumpStrength * 0.5f);
+                    velocity() = velocity() + wallNormal * (jumpStrength * 0.5f);
                 }
             }
             isGrounded = false;
@@ -122,7 +151,7 @@ public:
                 dashDir[dimState->visibleDims[1]] = normalizedInput.y;
                 dashDir[dimState->visibleDims[2]] = normalizedInput.z;
                 
-                velocity = dashDir.normalized() * dashSpeed;
+                velocity() = dashDir.normalized() * dashSpeed;
             }
         }
     }
@@ -155,27 +184,27 @@ private:
         inputVel[dimState->visibleDims[2]] = moveInput.z * moveSpeed;
         
         // Apply horizontal velocity
-        velocity[dimState->visibleDims[0]] = inputVel[dimState->visibleDims[0]];
-        velocity[dimState->visibleDims[2]] = inputVel[dimState->visibleDims[2]];
+        velocity()[dimState->visibleDims[0]] = inputVel[dimState->visibleDims[0]];
+        velocity()[dimState->visibleDims[2]] = inputVel[dimState->visibleDims[2]];
         
         // Apply gravity in the "up" dimension
         int upDim = dimState->visibleDims[1];
         if (!isGrounded) {
-            velocity[upDim] -= gravity * deltaTime;
+            velocity()[upDim] -= gravity * deltaTime;
             
             // Terminal velocity
-            if (velocity[upDim] < -maxFallSpeed) {
-                velocity[upDim] = -maxFallSpeed;
+            if (velocity()[upDim] < -maxFallSpeed) {
+                velocity()[upDim] = -maxFallSpeed;
             }
         }
         
         // Wall sliding
-        if (isOnWall && !isGrounded && velocity[upDim] < 0) {
-            velocity[upDim] = std::max(velocity[upDim], -wallSlideSpeed);
+        if (isOnWall && !isGrounded && velocity()[upDim] < 0) {
+            velocity()[upDim] = std::max(velocity()[upDim], -wallSlideSpeed);
         }
         
         // Update position
-        position += velocity * deltaTime;
+        position() += velocity() * deltaTime;
     }
 
     void updateDash(float deltaTime) {
@@ -184,10 +213,10 @@ private:
         if (dashTimer <= 0.0f) {
             isDashing = false;
             // Reduce velocity after dash
-            velocity = velocity * 0.5f;
+            velocity() = velocity() * 0.5f;
         }
         
         // Continue moving in dash direction (velocity already set)
-        position += velocity * deltaTime;
+        position() += velocity() * deltaTime;
     }
 };
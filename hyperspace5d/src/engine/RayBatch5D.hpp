@@ -0,0 +1,162 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * RayBatch5D - A batch of 5D rays stored as structure-of-arrays
+ *
+ * Queries that fire many rays at once (boss line of sight, aim and
+ * visibility probes) add them here and run them together. Each component
+ * lives in its own array so a group of Lanes rays can be loaded straight
+ * into lane arrays and tested against a box with the same branchless slab
+ * math per lane, which the compiler turns into SIMD.
+ *
+ * Results are written back per ray: the nearest object hit (or nullptr)
+ * and the distance along the ray.
+ */
+class RayBatch5D {
+public:
+    static constexpr int Lanes = 8;
+
+    std::vector<float> origin[5];
+    std::vector<float> direction[5];
+    std::vector<float> maxDistance;
+
+    std::vector<GameObject5D*> hitObject;
+    std::vector<float> hitDistance;
+
+    // Timing of the last query (for the debug UI)
+    float lastQueryMs;
+
+    RayBatch5D()
+        : lastQueryMs(0.0f)
+    {}
+
+    void clear() {
+        for (int i = 0; i < 5; ++i) {
+            origin[i].clear();
+            direction[i].clear();
+        }
+        maxDistance.clear();
+        hitObject.clear();
+        hitDistance.clear();
+    }
+
+    /**
+     * Queue a ray; returns its index in the batch.
+     */
+    int add(const Vec5D& rayOrigin, const Vec5D& rayDirection, float rayMaxDistance) {
+        for (int i = 0; i < 5; ++i) {
+            origin[i].push_back(rayOrigin[i]);
+            direction[i].push_back(rayDirection[i]);
+        }
+        maxDistance.push_back(rayMaxDistance);
+        hitObject.push_back(nullptr);
+        hitDistance.push_back(rayMaxDistance);
+        return static_cast<int>(maxDistance.size()) - 1;
+    }
+
+    int size() const {
+        return static_cast<int>(maxDistance.size());
+    }
+
+    bool hit(int ray) const {
+        return hitObject[ray] != nullptr;
+    }
+
+    Vec5D hitPoint(int ray) const {
+        Vec5D point;
+        for (int i = 0; i < 5; ++i) {
+            point[i] = origin[i][ray] + direction[i][ray] * hitDistance[ray];
+        }
+        return point;
+    }
+
+    /**
+     * Rays per second of the last query, in millions.
+     */
+    float lastMraysPerSecond() const {
+        if (lastQueryMs <= 0.0f) return 0.0f;
+        return size() / (lastQueryMs * 1000.0f);
+    }
+};
+
+/**
+ * RayPacket5D - Lanes rays of a batch unpacked for lane-wise slab tests
+ */
+struct RayPacket5D {
+    float origin[5][RayBatch5D::Lanes];
+    float invDirection[5][RayBatch5D::Lanes];
+    float closest[RayBatch5D::Lanes];         // Nearest hit so far (starts at max distance)
+    GameObject5D* hitObject[RayBatch5D::Lanes];
+    int first;                                // Index of lane 0 in the batch
+    int count;                                // Live lanes
+
+    /**
+     * Load rays [start, start + Lanes) of a batch. Missing lanes get a
+     * negative range so they never hit.
+     */
+    void load(const RayBatch5D& batch, int start) {
+        first = start;
+        count = std::min(RayBatch5D::Lanes, batch.size() - start);
+
+        for (int k = 0; k < RayBatch5D::Lanes; ++k) {
+            bool live = k < count;
+            int ray = live ? start + k : start;
+            for (int i = 0; i < 5; ++i) {
+                // Near-parallel axes get a huge finite inverse instead of inf,
+                // so 0 * inv never produces NaN
+                float d = batch.direction[i][ray];
+                origin[i][k] = batch.origin[i][ray];
+                invDirection[i][k] = std::abs(d) > 1e-6f ? 1.0f / d : std::copysign(1e30f, d);
+            }
+            closest[k] = live ? batch.maxDistance[ray] : -1.0f;
+            hitObject[k] = nullptr;
+        }
+    }
+
+    /**
+     * Write the lanes' results back to the batch.
+     */
+    void store(RayBatch5D& batch) const {
+        for (int k = 0; k < count; ++k) {
+            batch.hitObject[first + k] = hitObject[k];
+            batch.hitDistance[first + k] = closest[k];
+        }
+    }
+
+    /**
+     * Slab test of every lane against one box. Writes the entry distance
+     * per lane and returns a bit per lane whose ray enters the box before
+     * its closest hit so far.
+     */
+    unsigned intersect(const Vec5D& boxMin, const Vec5D& boxMax, float* tEntry) const {
+        float tNear[RayBatch5D::Lanes];
+        float tFar[RayBatch5D::Lanes];
+        for (int k = 0; k < RayBatch5D::Lanes; ++k) {
+            tNear[k] = 0.0f;
+            tFar[k] = closest[k];
+        }
+
+        for (int i = 0; i < 5; ++i) {
+            float lo = boxMin[i];
+            float hi = boxMax[i];
+            for (int k = 0; k < RayBatch5D::Lanes; ++k) {
+                float t1 = (lo - origin[i][k]) * invDirection[i][k];
+                float t2 = (hi - origin[i][k]) * invDirection[i][k];
+                tNear[k] = std::max(tNear[k], std::min(t1, t2));
+                tFar[k] = std::min(tFar[k], std::max(t1, t2));
+            }
+        }
+
+        unsigned mask = 0;
+        for (int k = 0; k < RayBatch5D::Lanes; ++k) {
+            tEntry[k] = tNear[k];
+            mask |= static_cast<unsigned>(tNear[k] <= tFar[k]) << k;
+        }
+        return mask;
+    }
+};
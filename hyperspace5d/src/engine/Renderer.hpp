@@ -9,8 +9,15 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <limits>
+#include <span>
 #include "../core/Projection5D.hpp"
 #include "GameObject5D.hpp"
+#include "EchoTrail5D.hpp"
+#include "EntityStore5D.hpp"
+#include "DynamicResolution.hpp"
+#include "ClusteredLighting.hpp"
+#include "SDFRaymarcher.hpp"
 
 /**
  * Shader - Manages OpenGL shader programs
@@ -72,16 +79,32 @@ public:
         glUseProgram(ID);
     }
 
-    void setMat4(const std::string& name, const glm::mat4& mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    void setMat4(const char* name, const glm::mat4& mat) const {
+        glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
-    void setVec3(const std::string& name, const glm::vec3& vec) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(vec));
+    void setVec3(const char* name, const glm::vec3& vec) const {
+        glUniform3fv(glGetUniformLocation(ID, name), 1, glm::value_ptr(vec));
     }
 
-    void setFloat(const std::string& name, float value) const {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    void setFloat(const char* name, float value) const {
+        glUniform1f(glGetUniformLocation(ID, name), value);
+    }
+
+    void setInt(const char* name, int value) const {
+        glUniform1i(glGetUniformLocation(ID, name), value);
+    }
+
+    void setVec2(const char* name, const glm::vec2& vec) const {
+        glUniform2fv(glGetUniformLocation(ID, name), 1, glm::value_ptr(vec));
+    }
+
+    void setIVec3(const char* name, int x, int y, int z) const {
+        glUniform3i(glGetUniformLocation(ID, name), x, y, z);
+    }
+
+    void setVec3Array(const char* name, const glm::vec3* values, int count) const {
+        glUniform3fv(glGetUniformLocation(ID, name), count, glm::value_ptr(values[0]));
     }
 
 private:
@@ -205,6 +228,153 @@ public:
         glDrawArrays(GL_TRIANGLES, 0, 36);
         glBindVertexArray(0);
     }
+
+    void drawInstanced(int count) const {
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, count);
+        glBindVertexArray(0);
+    }
+};
+
+/**
+ * RenderTarget - Offscreen color + depth framebuffer
+ *
+ * Storage is allocated at the maximum size once; callers render into a
+ * smaller sub-rectangle instead of reallocating when the resolution changes.
+ */
+class RenderTarget {
+public:
+    GLuint FBO, colorTexture, depthRBO;
+    int width, height;
+
+    RenderTarget() : FBO(0), colorTexture(0), depthRBO(0), width(0), height(0) {}
+
+    ~RenderTarget() {
+        destroy();
+    }
+
+    bool create(int w, int h) {
+        destroy();
+        width = w;
+        height = h;
+
+        glGenFramebuffers(1, &FBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+        glGenTextures(1, &colorTexture);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+
+        glGenRenderbuffers(1, &depthRBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        if (!complete) {
+            std::cerr << "Offscreen framebuffer is incomplete" << std::endl;
+            destroy();
+            return false;
+        }
+        return true;
+    }
+
+    void destroy() {
+        if (depthRBO) glDeleteRenderbuffers(1, &depthRBO);
+        if (colorTexture) glDeleteTextures(1, &colorTexture);
+        if (FBO) glDeleteFramebuffers(1, &FBO);
+        FBO = colorTexture = depthRBO = 0;
+        width = height = 0;
+    }
+
+    /**
+     * Bind for drawing and restrict the viewport to the top-left w x h region
+     */
+    void bind(int w, int h) const {
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glViewport(0, 0, w, h);
+    }
+
+    /**
+     * Upscale the w x h region to the default framebuffer
+     */
+    void blitToScreen(int w, int h, int screenWidth, int screenHeight) const {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, screenWidth, screenHeight,
+                          GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, screenWidth, screenHeight);
+    }
+};
+
+/**
+ * GpuTimer - Measures GPU time of a pass without stalling the pipeline
+ *
+ * Uses a small ring of GL_TIME_ELAPSED queries and only reads results that
+ * are already available, so the reported time lags a frame or two behind.
+ */
+class GpuTimer {
+public:
+    static constexpr int QueryCount = 4;
+
+    GLuint queries[QueryCount];
+    bool pending[QueryCount];
+    int current;
+    float lastMs;
+
+    GpuTimer() : current(0), lastMs(0.0f) {
+        for (int i = 0; i < QueryCount; ++i) {
+            queries[i] = 0;
+            pending[i] = false;
+        }
+    }
+
+    ~GpuTimer() {
+        if (queries[0]) glDeleteQueries(QueryCount, queries);
+    }
+
+    void create() {
+        glGenQueries(QueryCount, queries);
+    }
+
+    void begin() {
+        glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+    }
+
+    void end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        pending[current] = true;
+        current = (current + 1) % QueryCount;
+    }
+
+    /**
+     * Collect the oldest finished result, if any.
+     *
+     * @return true if lastMs was updated
+     */
+    bool poll() {
+        // The slot we are about to reuse is the oldest one in flight
+        int oldest = current;
+        if (!pending[oldest]) return false;
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(queries[oldest], GL_QUERY_RESULT, &elapsedNs);
+        pending[oldest] = false;
+        lastMs = static_cast<float>(elapsedNs) / 1.0e6f;
+        return true;
+    }
 };
 
 /**
@@ -213,21 +383,80 @@ public:
 class Renderer {
 public:
     Shader shader;
+    Shader echoShader;        // Instanced echo trails
     Mesh cubeMesh;
     Projection5D projection;
     glm::vec3 cameraPos;
     glm::vec3 lightPos;
 
-    Renderer() : cameraPos(0.0f, 5.0f, 15.0f), lightPos(10.0f, 10.0f, 10.0f) {}
-
-    bool initialize() {
+    // Scene is drawn offscreen at a scaled resolution, then upscaled
+    RenderTarget sceneTarget;
+    GpuTimer sceneTimer;
+    DynamicResolution dynamicResolution;
+    int renderWidth, renderHeight;
+
+    // Point lights from glowing objects, on top of the fixed key light
+    ClusteredLighting lighting;
+    bool useClusteredLights;
+
+    // Portal windows: one offscreen target per recursion level
+    static constexpr int MaxPortalDepth = 3;
+    Shader portalShader;
+    RenderTarget portalTargets[MaxPortalDepth];
+    int maxPortalDepth;
+    int portalViewsRendered;
+
+    // Alternative to cube rasterization: sphere-trace the exact 3D slice
+    Shader raymarchShader;
+    SDFRaymarcher raymarcher;
+    bool useRaymarching;
+
+    Renderer()
+        : cameraPos(0.0f, 5.0f, 15.0f)
+        , lightPos(10.0f, 10.0f, 10.0f)
+        , renderWidth(0)
+        , renderHeight(0)
+        , useClusteredLights(true)
+        , maxPortalDepth(2)
+        , portalViewsRendered(0)
+        , useRaymarching(false)
+    {}
+
+    bool initialize(int screenWidth, int screenHeight) {
         if (!shader.load("shaders/vertex.glsl", "shaders/fragment.glsl")) {
             std::cerr << "Failed to load shaders" << std::endl;
             return false;
         }
 
+        if (!echoShader.load("shaders/echo_vertex.glsl", "shaders/fragment.glsl")) {
+            std::cerr << "Failed to load echo shaders" << std::endl;
+            return false;
+        }
+
+        if (!portalShader.load("shaders/vertex.glsl", "shaders/portal_fragment.glsl")) {
+            std::cerr << "Failed to load portal shaders" << std::endl;
+            return false;
+        }
+
+        if (!raymarchShader.load("shaders/fullscreen_vertex.glsl", "shaders/raymarch_fragment.glsl")) {
+            std::cerr << "Failed to load raymarch shaders" << std::endl;
+            return false;
+        }
+
         cubeMesh.createCube();
 
+        if (!sceneTarget.create(screenWidth, screenHeight)) {
+            return false;
+        }
+        for (RenderTarget& target : portalTargets) {
+            if (!target.create(screenWidth, screenHeight)) {
+                return false;
+            }
+        }
+        sceneTimer.create();
+        lighting.create();
+        raymarcher.create();
+
         glEnable(GL_DEPTH_TEST);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -236,27 +465,40 @@ public:
     }
 
     void renderObject(const GameObject5D& obj, const DimensionState& dimState,
-                     const glm::mat4& view, const glm::mat4& projection) {
-        
-        if (!obj.isVisible) return;
+                     const glm::mat4& view, const glm::mat4& projection,
+                     const Vec5D& viewOffset = Vec5D()) {
+        renderBody(*obj.body, obj.bodyRow, dimState, view, projection, viewOffset);
+    }
+
+    /**
+     * Draw one body as a box, from its row in a set of body columns.
+     */
+    void renderBody(const BodyColumns5D& body, int row, const DimensionState& dimState,
+                    const glm::mat4& view, const glm::mat4& projection,
+                    const Vec5D& viewOffset = Vec5D()) {
+
+        if (!body.visible[row]) return;
+
+        // Objects seen through a portal are drawn relative to its far end
+        Vec5D position = body.position[row] - viewOffset;
 
         // Project 5D position to 3D
-        glm::vec3 pos3D = this->projection.project(obj.position, dimState);
-        glm::vec3 size3D = obj.size.slice(
+        glm::vec3 pos3D = this->projection.project(position, dimState);
+        glm::vec3 size3D = body.size[row].slice(
             dimState.visibleDims[0],
             dimState.visibleDims[1],
             dimState.visibleDims[2]
         );
 
         // Calculate scale based on hidden dimensions
-        float hiddenScale = this->projection.calculateScale(obj.position, dimState);
+        float hiddenScale = this->projection.calculateScale(position, dimState);
         size3D *= hiddenScale;
 
         // Calculate opacity
-        float opacity = obj.opacity * this->projection.calculateOpacity(obj.position, dimState);
+        float opacity = body.opacity[row] * this->projection.calculateOpacity(position, dimState);
 
         // Calculate color tint from hidden dimensions
-        glm::vec3 tint = this->projection.calculateHiddenDimTint(obj.position, dimState);
+        glm::vec3 tint = this->projection.calculateHiddenDimTint(position, dimState);
 
         // Create model matrix
         glm::mat4 model = glm::mat4(1.0f);
@@ -268,7 +510,7 @@ public:
         shader.setMat4("uModel", model);
         shader.setMat4("uView", view);
         shader.setMat4("uProjection", projection);
-        shader.setVec3("uColor", obj.color);
+        shader.setVec3("uColor", body.color[row]);
         shader.setFloat("uOpacity", opacity);
         shader.setVec3("uLightPos", lightPos);
         shader.setVec3("uViewPos", cameraPos);
@@ -277,22 +519,388 @@ public:
         cubeMesh.draw();
     }
 
-    void renderScene(const std::vector<std::shared_ptr<GameObject5D>>& objects,
+    /**
+     * Draw every echo of a trail with one instanced draw call.
+     * The rotation is linear, so rotating the source and the step once
+     * is enough for the shader to place all echoes.
+     */
+    void renderEchoTrail(const EchoTrail5D& trail, const DimensionState& dimState,
+                         const glm::mat4& view, const glm::mat4& projection,
+                         const Vec5D& viewOffset = Vec5D()) {
+
+        if (!trail.isVisible() || trail.echoCount() <= 0) return;
+
+        Matrix5D rotation = dimState.getCurrentRotation();
+        Vec5D base = rotation * (trail.position() - viewOffset);
+        Vec5D step = rotation * trail.echoStep;
+
+        // Split into the visible slice and the two hidden dimensions
+        std::array<bool, 5> isVisible = {false, false, false, false, false};
+        for (int vis : dimState.visibleDims) {
+            isVisible[vis] = true;
+        }
+        glm::vec2 baseHidden(0.0f), stepHidden(0.0f);
+        int hiddenIdx = 0;
+        for (int i = 0; i < 5 && hiddenIdx < 2; ++i) {
+            if (!isVisible[i]) {
+                baseHidden[hiddenIdx] = base[i];
+                stepHidden[hiddenIdx] = step[i];
+                ++hiddenIdx;
+            }
+        }
+
+        const int* dims = dimState.visibleDims.data();
+        echoShader.use();
+        echoShader.setMat4("uView", view);
+        echoShader.setMat4("uProjection", projection);
+        echoShader.setVec3("uBaseVisible", base.slice(dims[0], dims[1], dims[2]));
+        echoShader.setVec2("uBaseHidden", baseHidden);
+        echoShader.setVec3("uStepVisible", step.slice(dims[0], dims[1], dims[2]));
+        echoShader.setVec2("uStepHidden", stepHidden);
+        echoShader.setVec3("uEchoSize", trail.size().slice(dims[0], dims[1], dims[2]));
+        echoShader.setInt("uFirstEcho", trail.firstEcho);
+        echoShader.setVec3("uColor", trail.color());
+        echoShader.setVec3("uEchoColorStep", trail.echoColorStep);
+        echoShader.setFloat("uOpacity", trail.opacity());
+        echoShader.setFloat("uEchoFade", trail.echoFade);
+        echoShader.setFloat("uHiddenDimScale", this->projection.hiddenDimScale);
+        echoShader.setFloat("uHiddenDimAlpha", this->projection.hiddenDimAlpha);
+        echoShader.setInt("uUsePerspective", this->projection.usePerspective ? 1 : 0);
+        echoShader.setVec3("uLightPos", lightPos);
+        echoShader.setVec3("uViewPos", cameraPos);
+
+        cubeMesh.drawInstanced(trail.echoCount());
+    }
+
+    /**
+     * Draw the level: every entity table row straight from its table's
+     * columns, then the objects without a row (the player included).
+     */
+    void renderScene(const EntityStore5D& entities,
+                    std::span<GameObject5D* const> objects,
+                    const std::vector<Portal5D*>& portals,
                     const DimensionState& dimState,
                     int screenWidth, int screenHeight) {
         
+        // Pick this frame's resolution from the last available GPU timing
+        if (sceneTimer.poll()) {
+            dynamicResolution.update(sceneTimer.lastMs);
+        }
+        renderWidth = std::min(dynamicResolution.scaledWidth(screenWidth), sceneTarget.width);
+        renderHeight = std::min(dynamicResolution.scaledHeight(screenHeight), sceneTarget.height);
+
+        sceneTimer.begin();
+        sceneTarget.bind(renderWidth, renderHeight);
+
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // Create view and projection matrices
-        glm::mat4 view = glm::lookAt(cameraPos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 proj = glm::perspective(glm::radians(45.0f), 
-                                          (float)screenWidth / (float)screenHeight,
-                                          0.1f, 100.0f);
+        glm::mat4 view = viewMatrix();
+        glm::mat4 proj = projectionMatrix((float)screenWidth / (float)screenHeight);
+
+        if (useRaymarching) {
+            renderRaymarched(entities, objects, dimState, view, proj);
+
+            sceneTimer.end();
+            sceneTarget.blitToScreen(renderWidth, renderHeight, screenWidth, screenHeight);
+            return;
+        }
+
+        // Bin this frame's point lights into the froxel grid
+        if (useClusteredLights) {
+            lighting.collectLights(entities, objects, projection, dimState);
+            lighting.buildClusters(view, proj);
+            lighting.upload();
+        }
+
+        for (const Shader* lit : {&shader, &echoShader}) {
+            lit->use();
+            lit->setIVec3("uClusterDims", ClusteredLighting::TilesX, ClusteredLighting::TilesY,
+                          ClusteredLighting::Slices);
+            lit->setVec2("uViewportSize", glm::vec2(renderWidth, renderHeight));
+            lit->setFloat("uClusterNear", lighting.clusterNear);
+            lit->setFloat("uClusterFar", lighting.clusterFar);
+        }
+
+        // Render all objects, recursing through any visible portals
+        portalViewsRendered = 0;
+        ScreenRect fullView = {0, 0, renderWidth, renderHeight};
+        renderView(entities, objects, portals, dimState, view, proj, Vec5D(), fullView, 0.0f, 0, sceneTarget);
+
+        sceneTimer.end();
+
+        // Upscale to the window; UI is drawn on top at native resolution
+        sceneTarget.blitToScreen(renderWidth, renderHeight, screenWidth, screenHeight);
+    }
+
+    glm::mat4 viewMatrix() const {
+        return glm::lookAt(cameraPos, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    glm::mat4 projectionMatrix(float aspect) const {
+        return glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
+    }
+
+    /**
+     * Sphere-trace the slice in one fullscreen pass.
+     * Portal views are not traced; portals show as plain boxes.
+     */
+    void renderRaymarched(const EntityStore5D& entities,
+                          std::span<GameObject5D* const> objects,
+                          const DimensionState& dimState,
+                          const glm::mat4& view, const glm::mat4& proj) {
+        raymarcher.build(entities, objects, dimState);
+        raymarcher.upload();
+
+        raymarchShader.use();
+        raymarchShader.setMat4("uInvViewProj", glm::inverse(proj * view));
+        raymarchShader.setVec3("uViewPos", cameraPos);
+        raymarchShader.setVec3("uLightPos", lightPos);
+        raymarchShader.setVec3Array("uSliceRows", raymarcher.sliceRows.data(), 5);
+        raymarchShader.setVec3Array("uSliceProject", raymarcher.sliceProject.data(), 5);
+        raymarchShader.setVec3("uGridMin", raymarcher.gridMin);
+        raymarchShader.setVec3("uCellSize", raymarcher.cellSize);
+        raymarchShader.setIVec3("uGridDims", raymarcher.gridDims.x, raymarcher.gridDims.y,
+                                raymarcher.gridDims.z);
+        raymarchShader.setInt("uMaxSteps", raymarcher.maxSteps);
+        raymarchShader.setFloat("uHitEpsilon", raymarcher.hitEpsilon);
+        raymarchShader.setFloat("uFogDensity", raymarcher.fogDensity);
+        raymarchShader.setFloat("uFogFalloff", raymarcher.fogFalloff);
+        raymarchShader.setFloat("uFogEdge", raymarcher.fogEdge);
+        raymarchShader.setFloat("uFogStep", raymarcher.fogStep);
+        raymarchShader.setVec3("uBackground", raymarcher.background);
+
+        glDisable(GL_DEPTH_TEST);
+        raymarcher.drawFullscreen();
+        glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    /**
+     * Pixel rectangle in the current render target (x1/y1 exclusive)
+     */
+    struct ScreenRect {
+        int x0, y0, x1, y1;
+
+        bool isEmpty() const { return x0 >= x1 || y0 >= y1; }
+
+        ScreenRect intersect(const ScreenRect& other) const {
+            return {std::max(x0, other.x0), std::max(y0, other.y0),
+                    std::min(x1, other.x1), std::min(y1, other.y1)};
+        }
+    };
+
+    /**
+     * Project a 3D box to a pixel rectangle and its nearest view depth.
+     * Boxes crossing the camera plane get the whole view (conservative).
+     */
+    bool projectBox(const glm::vec3& center, const glm::vec3& halfSize,
+                    const glm::mat4& view, const glm::mat4& proj,
+                    ScreenRect& rect, float& nearDepth, float& farDepth) const {
+        glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+        nearDepth = std::numeric_limits<float>::max();
+        farDepth = 0.0f;
+        bool crossesCamera = false;
+
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 p = center + glm::vec3(
+                (corner & 1) ? halfSize.x : -halfSize.x,
+                (corner & 2) ? halfSize.y : -halfSize.y,
+                (corner & 4) ? halfSize.z : -halfSize.z
+            );
+            glm::vec4 viewPos = view * glm::vec4(p, 1.0f);
+            nearDepth = std::min(nearDepth, -viewPos.z);
+            farDepth = std::max(farDepth, -viewPos.z);
+
+            glm::vec4 clip = proj * viewPos;
+            if (clip.w <= 0.1f) {
+                crossesCamera = true;
+                continue;
+            }
+            ndcMin.x = std::min(ndcMin.x, clip.x / clip.w);
+            ndcMin.y = std::min(ndcMin.y, clip.y / clip.w);
+            ndcMax.x = std::max(ndcMax.x, clip.x / clip.w);
+            ndcMax.y = std::max(ndcMax.y, clip.y / clip.w);
+        }
+
+        if (farDepth <= 0.0f) return false;   // Entirely behind the camera
+        if (crossesCamera) {
+            rect = {0, 0, renderWidth, renderHeight};
+            return true;
+        }
+
+        rect.x0 = static_cast<int>(std::floor((ndcMin.x * 0.5f + 0.5f) * renderWidth));
+        rect.y0 = static_cast<int>(std::floor((ndcMin.y * 0.5f + 0.5f) * renderHeight));
+        rect.x1 = static_cast<int>(std::ceil((ndcMax.x * 0.5f + 0.5f) * renderWidth));
+        rect.y1 = static_cast<int>(std::ceil((ndcMax.y * 0.5f + 0.5f) * renderHeight));
+        return true;
+    }
+
+    /**
+     * Projected 3D box of an object as seen from a (portal) view offset
+     */
+    void objectBox(const GameObject5D& obj, const DimensionState& dimState,
+                   const Vec5D& viewOffset, glm::vec3& center, glm::vec3& halfSize) const {
+        Vec5D boundsMin, boundsMax;
+        obj.getBounds(boundsMin, boundsMax);
+        boundsBox(boundsMin, boundsMax, dimState, viewOffset, center, halfSize);
+    }
+
+    /**
+     * Projected 3D box of a 5D box as seen from a (portal) view offset
+     */
+    void boundsBox(const Vec5D& boundsMin, const Vec5D& boundsMax, const DimensionState& dimState,
+                   const Vec5D& viewOffset, glm::vec3& center, glm::vec3& halfSize) const {
+        Vec5D position = (boundsMin + boundsMax) * 0.5f - viewOffset;
+        Vec5D extent = boundsMax - boundsMin;
+        center = projection.project(position, dimState);
+        halfSize = extent.slice(dimState.visibleDims[0], dimState.visibleDims[1],
+                                dimState.visibleDims[2])
+                   * (0.5f * projection.calculateScale(position, dimState));
+    }
+
+    /**
+     * Draw one view of the scene into the bound target, then fill every
+     * visible portal with the view from its linked end.
+     *
+     * Portal views are drawn into portalTargets[depth] restricted (scissor
+     * and culling) to the portal's screen rectangle, so their cost scales
+     * with the portal's size on screen rather than the whole scene.
+     *
+     * @param viewOffset 5D translation of this view (sum of portal offsets)
+     * @param clip       Screen region this view may touch
+     * @param minDepth   Objects closer than this sit between the camera and
+     *                   the portal and are skipped
+     * @param depth      Portal recursion depth (0 = main view)
+     */
+    void renderView(const EntityStore5D& entities,
+                    std::span<GameObject5D* const> objects,
+                    const std::vector<Portal5D*>& portals,
+                    const DimensionState& dimState,
+                    const glm::mat4& view, const glm::mat4& proj,
+                    const Vec5D& viewOffset, const ScreenRect& clip, float minDepth,
+                    int depth, const RenderTarget& target) {
+
+        bool isPortalView = depth > 0;
+        if (isPortalView) {
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(clip.x0, clip.y0, clip.x1 - clip.x0, clip.y1 - clip.y0);
+        }
+
+        // Lights are binned for the main view only
+        for (const Shader* lit : {&shader, &echoShader}) {
+            lit->use();
+            lit->setInt("uUseClusteredLights", (useClusteredLights && !isPortalView) ? 1 : 0);
+        }
+
+        // Cull to the portal's screen-space frustum
+        auto outsidePortal = [&](const glm::vec3& center, const glm::vec3& halfSize) {
+            ScreenRect rect;
+            float nearDepth, farDepth;
+            if (!projectBox(center, halfSize, view, proj, rect, nearDepth, farDepth)) return true;
+            return farDepth < minDepth || rect.intersect(clip).isEmpty();
+        };
+
+        entities.forEachTable([&](const EntityTable5D& table) {
+            const BodyColumns5D& body = table.columns;
+            for (int row = 0; row < table.rowCount(); ++row) {
+                if (!body.visible[row]) continue;
+
+                if (isPortalView) {
+                    glm::vec3 center, halfSize;
+                    boundsBox(body.boundsMin[row], body.boundsMax[row], dimState, viewOffset, center, halfSize);
+                    if (outsidePortal(center, halfSize)) continue;
+                }
+
+                renderBody(body, row, dimState, view, proj, viewOffset);
+            }
+        });
 
-        // Render all objects
         for (const auto& obj : objects) {
-            renderObject(*obj, dimState, view, proj);
+            if (!obj->isVisible()) continue;
+            if (obj->typeTag == Portal5D::tag()) continue;
+
+            if (isPortalView) {
+                glm::vec3 center, halfSize;
+                objectBox(*obj, dimState, viewOffset, center, halfSize);
+                if (outsidePortal(center, halfSize)) continue;
+            }
+
+            if (obj->typeTag == EchoTrail5D::tag() && obj->instanceCount() > 1) {
+                renderEchoTrail(static_cast<const EchoTrail5D&>(*obj), dimState, view, proj, viewOffset);
+                continue;
+            }
+
+            renderObject(*obj, dimState, view, proj, viewOffset);
         }
+
+        for (Portal5D* portal : portals) {
+            if (!portal->isVisible()) continue;
+
+            glm::vec3 center, halfSize;
+            objectBox(*portal, dimState, viewOffset, center, halfSize);
+            ScreenRect rect;
+            float nearDepth, farDepth;
+            if (!projectBox(center, halfSize, view, proj, rect, nearDepth, farDepth)) continue;
+            if (farDepth < minDepth) continue;
+            rect = rect.intersect(clip);
+            if (rect.isEmpty()) continue;
+
+            if (depth >= maxPortalDepth || !portal->linked) {
+                // Recursion cap: show the portal as a plain translucent pad
+                renderObject(*portal, dimState, view, proj, viewOffset);
+                continue;
+            }
+
+            // Render the far side into this depth's texture
+            const RenderTarget& remote = portalTargets[depth];
+            remote.bind(renderWidth, renderHeight);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0);
+            glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            ++portalViewsRendered;
+            renderView(entities, objects, portals, dimState, view, proj,
+                       viewOffset + portal->linkOffset(), rect, nearDepth, depth + 1, remote);
+
+            // Back to this view's target and draw the portal as a window
+            target.bind(renderWidth, renderHeight);
+            if (isPortalView) {
+                glScissor(clip.x0, clip.y0, clip.x1 - clip.x0, clip.y1 - clip.y0);
+            } else {
+                glDisable(GL_SCISSOR_TEST);
+            }
+            renderPortalSurface(*portal, dimState, view, proj, viewOffset, remote);
+        }
+
+        if (!isPortalView) {
+            glDisable(GL_SCISSOR_TEST);
+        }
+    }
+
+    void renderPortalSurface(const Portal5D& portal, const DimensionState& dimState,
+                             const glm::mat4& view, const glm::mat4& projection,
+                             const Vec5D& viewOffset, const RenderTarget& remote) {
+        glm::vec3 center, halfSize;
+        objectBox(portal, dimState, viewOffset, center, halfSize);
+
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, center);
+        model = glm::scale(model, halfSize * 2.0f);
+
+        portalShader.use();
+        portalShader.setMat4("uModel", model);
+        portalShader.setMat4("uView", view);
+        portalShader.setMat4("uProjection", projection);
+        portalShader.setVec3("uColor", portal.color());
+        portalShader.setVec2("uTargetSize", glm::vec2(remote.width, remote.height));
+        portalShader.setInt("uPortalView", 0);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, remote.colorTexture);
+        cubeMesh.draw();
+        glBindTexture(GL_TEXTURE_2D, 0);
     }
 };
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * RewindBuffer5D - The last few seconds of simulation state, compressed
+ *
+ * Each recorded frame is a fixed-length array of floats (the caller decides
+ * what goes in it). Values are quantized to multiples of quantum. Frames
+ * are grouped into blocks: the first frame of a block is a keyframe stored
+ * as is, and the rest store only how far each value is from the keyframe,
+ * as runs of unchanged values followed by zigzag varints. Most of a level
+ * doesn't move between frames, so a delta frame is usually a few bytes.
+ *
+ * Any frame decodes straight from its own block's keyframe, so scrubbing
+ * backward costs the same per frame however far back it goes. When full,
+ * the oldest block is dropped whole and its buffers reused for the next
+ * one, so recording stops allocating once every block has been filled once.
+ */
+class RewindBuffer5D {
+public:
+    float quantum;                  // Smallest difference kept
+
+    explicit RewindBuffer5D(int frames = 3600, int keyframeInterval = 120, float step = 1.0f / 4096.0f)
+        : quantum(step)
+        , interval(1)
+        , oldest(0)
+        , blockCount(0)
+        , frameCount(0)
+        , valueCount(0)
+        , largestBlock(0)
+    {
+        resize(frames, keyframeInterval);
+    }
+
+    /**
+     * Hold frames frames from now on, with a keyframe every
+     * keyframeInterval. The history starts over.
+     */
+    void resize(int frames, int keyframeInterval) {
+        interval = std::max(keyframeInterval, 1);
+
+        // One block more than the capacity needs, so dropping the oldest
+        // never leaves less than the capacity behind
+        blocks.resize((std::max(frames, 1) + interval - 1) / interval + 1);
+        clear();
+    }
+
+    void clear() {
+        for (Block& block : blocks) {
+            block.frames = 0;
+        }
+        largestBlock = 0;
+        oldest = 0;
+        blockCount = 0;
+        frameCount = 0;
+    }
+
+    /**
+     * Append a frame. A frame with a different number of values than the
+     * last one starts the history over.
+     */
+    void record(std::span<const float> values) {
+        if (values.size() != valueCount) {
+            clear();
+            valueCount = values.size();
+        }
+        quantized.resize(valueCount);
+        float scale = 1.0f / quantum;
+        for (size_t i = 0; i < valueCount; ++i) {
+            float steps = std::clamp(values[i] * scale, -2.0e9f, 2.0e9f);
+            quantized[i] = static_cast<int32_t>(steps + std::copysign(0.5f, steps));
+        }
+
+        int blockTotal = static_cast<int>(blocks.size());
+        if (blockCount == 0 || blocks[newestIndex()].frames == interval) {
+            int index = (oldest + blockCount) % blockTotal;
+            if (blockCount == blockTotal) {
+                frameCount -= blocks[oldest].frames;
+                oldest = (oldest + 1) % blockTotal;
+                --blockCount;
+            }
+            Block& block = blocks[index];
+            block.key = quantized;
+            block.bytes.clear();
+            block.bytes.reserve(largestBlock);
+            block.offsets.clear();
+            block.offsets.push_back(0);
+            block.frames = 1;
+            ++blockCount;
+        } else {
+            Block& block = blocks[newestIndex()];
+            block.offsets.push_back(static_cast<uint32_t>(block.bytes.size()));
+            encode(block);
+            ++block.frames;
+            largestBlock = std::max(largestBlock, block.bytes.capacity());
+        }
+        ++frameCount;
+    }
+
+    /**
+     * Decode the frame back frames before the newest (0 is the newest).
+     */
+    bool read(int back, std::vector<float>& out) const {
+        if (back < 0 || back >= frameCount) return false;
+        int frame = frameCount - 1 - back;
+        int blockTotal = static_cast<int>(blocks.size());
+        int index = oldest;
+        while (frame >= blocks[index].frames) {
+            frame -= blocks[index].frames;
+            index = (index + 1) % blockTotal;
+        }
+
+        const Block& block = blocks[index];
+        out.resize(valueCount);
+        if (frame == 0) {
+            for (size_t i = 0; i < valueCount; ++i) {
+                out[i] = static_cast<float>(block.key[i]) * quantum;
+            }
+            return true;
+        }
+
+        const uint8_t* cursor = block.bytes.data() + block.offsets[frame];
+        size_t i = 0;
+        while (i < valueCount) {
+            size_t run = std::min(static_cast<size_t>(readVarint(cursor)), valueCount - i);
+            for (size_t end = i + run; i < end; ++i) {
+                out[i] = static_cast<float>(block.key[i]) * quantum;
+            }
+            if (i >= valueCount) break;
+            int64_t delta = unzigzag(readVarint(cursor));
+            out[i] = static_cast<float>(block.key[i] + delta) * quantum;
+            ++i;
+        }
+        return true;
+    }
+
+    /**
+     * Forget the newest count frames, e.g. after play resumes from an
+     * older one.
+     */
+    void discardNewest(int count) {
+        count = std::min(count, frameCount);
+        while (count > 0) {
+            Block& block = blocks[newestIndex()];
+            int taken = std::min(count, block.frames);
+            block.frames -= taken;
+            if (block.frames == 0) {
+                --blockCount;
+            } else {
+                block.bytes.resize(block.offsets[block.frames]);
+                block.offsets.resize(block.frames);
+            }
+            frameCount -= taken;
+            count -= taken;
+        }
+    }
+
+    int getFrameCount() const {
+        return frameCount;
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = 0;
+        for (const Block& block : blocks) {
+            bytes += block.key.capacity() * sizeof(int32_t) + block.bytes.capacity() +
+                     block.offsets.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+
+private:
+    struct Block {
+        std::vector<int32_t> key;       // Quantized keyframe
+        std::vector<uint8_t> bytes;     // Delta frames back to back
+        std::vector<uint32_t> offsets;  // Where each frame starts in bytes (frame 0 is the keyframe)
+        int frames;
+
+        Block() : frames(0) {}
+    };
+
+    std::vector<Block> blocks;      // Ring, oldest first from oldest
+    std::vector<int32_t> quantized; // Frame being recorded
+    int interval;                   // Frames per block
+    int oldest;
+    int blockCount;
+    int frameCount;
+    size_t valueCount;
+    size_t largestBlock;            // Biggest delta buffer any block has grown to; new blocks reserve it
+
+    int newestIndex() const {
+        return (oldest + blockCount - 1) % static_cast<int>(blocks.size());
+    }
+
+    void encode(Block& block) {
+        uint32_t run = 0;
+        for (size_t i = 0; i < valueCount; ++i) {
+            int64_t delta = static_cast<int64_t>(quantized[i]) - block.key[i];
+            if (delta == 0) {
+                ++run;
+                continue;
+            }
+            writeVarint(block.bytes, run);
+            writeVarint(block.bytes, zigzag(delta));
+            run = 0;
+        }
+        if (run > 0) {
+            writeVarint(block.bytes, run);
+        }
+    }
+
+    static uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    static void writeVarint(std::vector<uint8_t>& bytes, uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    static uint64_t readVarint(const uint8_t*& cursor) {
+        uint64_t value = 0;
+        int shift = 0;
+        while (*cursor & 0x80) {
+            value |= static_cast<uint64_t>(*cursor++ & 0x7f) << shift;
+            shift += 7;
+        }
+        value |= static_cast<uint64_t>(*cursor++) << shift;
+        return value;
+    }
+};
@@ -0,0 +1,584 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+#include "../core/DimensionState.hpp"
+#include "GameObject5D.hpp"
+#include "EntityStore5D.hpp"
+
+/**
+ * SDFRaymarcher - Sphere-traces the visible 3D slice of the level's 5D boxes
+ *
+ * Instead of projecting cubes, every pixel marches a ray through the current
+ * 3D slice of 5D space. A slice point p maps back to the 5D point
+ * w = A * p, where the columns of A are the visible rows of the view
+ * rotation. The distance to each box is the exact 5D box SDF at w, which
+ * never overestimates the distance to the box's cross-section with the
+ * slice, so the surfaces we hit are the exact rotated cross-sections.
+ *
+ * Boxes that miss the slice but are close to it in hidden dimensions show
+ * up as soft fog inside their shadow on the slice, fading with the hidden
+ * distance.
+ *
+ * Boxes are binned into a uniform 3D grid over the slice; rays walk the
+ * grid with a 3D DDA and only evaluate the boxes listed in the current cell,
+ * so per-pixel cost follows the local box density rather than the total.
+ *
+ * The same scene description drives the fragment shader path
+ * (shaders/raymarch_fragment.glsl) and a tiled multithreaded CPU path used
+ * for headless renders.
+ *
+ * GPU layout (std430 shader storage buffers):
+ *   binding 3: boxes   - vec4 center xyzw, vec4 halfSize xyzw,
+ *                        vec4 (center v, halfSize v, -, -), vec4 color/opacity
+ *   binding 4: cells   - uvec2 offset/count into the index list
+ *   binding 5: indices - uint box index per cell entry
+ */
+class SDFRaymarcher {
+public:
+    static constexpr int MaxGridDim = 64;
+
+    struct Box {
+        float center[5];
+        float halfSize[5];
+        glm::vec3 color;
+        float opacity;
+    };
+
+    struct GpuBox {
+        glm::vec4 center;           // x, y, z, w
+        glm::vec4 halfSize;         // x, y, z, w
+        glm::vec4 extra;            // center v, halfSize v
+        glm::vec4 colorOpacity;
+    };
+
+    // Slice mapping: w[i] = dot(sliceRows[i], p), and sliceProject[i] is
+    // column i of the pseudo-inverse, taking a 5D offset back onto the slice
+    std::array<glm::vec3, 5> sliceRows;
+    std::array<glm::vec3, 5> sliceProject;
+
+    std::vector<Box> boxes;
+
+    // Acceleration grid over the slice
+    glm::vec3 gridMin;
+    glm::vec3 cellSize;
+    glm::ivec3 gridDims;
+    std::vector<uint32_t> cells;          // offset, count pairs
+    std::vector<uint32_t> cellBoxes;
+
+    // Marching parameters
+    int maxSteps;
+    float hitEpsilon;
+    float fogDensity;         // Fog opacity per unit length at full density
+    float fogFalloff;         // Hidden distance over which fog fades by 1/e
+    float fogEdge;            // Width of the soft edge around a box's shadow
+    float fogStep;            // Longest step taken while inside fog
+    glm::vec3 background;
+
+    SDFRaymarcher()
+        : gridMin(0.0f)
+        , cellSize(1.0f)
+        , gridDims(0)
+        , maxSteps(192)
+        , hitEpsilon(1e-3f)
+        , fogDensity(0.6f)
+        , fogFalloff(2.0f)
+        , fogEdge(0.25f)
+        , fogStep(0.25f)
+        , background(0.1f, 0.1f, 0.15f)
+        , boxSSBO(0)
+        , cellSSBO(0)
+        , indexSSBO(0)
+        , fullscreenVAO(0)
+    {}
+
+    ~SDFRaymarcher() {
+        if (boxSSBO) glDeleteBuffers(1, &boxSSBO);
+        if (cellSSBO) glDeleteBuffers(1, &cellSSBO);
+        if (indexSSBO) glDeleteBuffers(1, &indexSSBO);
+        if (fullscreenVAO) glDeleteVertexArrays(1, &fullscreenVAO);
+    }
+
+    void create() {
+        glGenBuffers(1, &boxSSBO);
+        glGenBuffers(1, &cellSSBO);
+        glGenBuffers(1, &indexSSBO);
+        glGenVertexArrays(1, &fullscreenVAO);
+    }
+
+    /**
+     * Build the scene description for the current slice: every entity
+     * table row, read from the body columns, then every instance of the
+     * other objects (e.g. each echo of a trail) as a box.
+     */
+    void build(const EntityStore5D& entities, std::span<GameObject5D* const> objects,
+               const DimensionState& dimState) {
+        computeSlice(dimState);
+
+        boxes.clear();
+        boxBounds.clear();
+        float fogRange = fogFalloff * 3.0f;
+
+        entities.forEachTable([&](const EntityTable5D& table) {
+            for (int row = 0; row < table.rowCount(); ++row) {
+                if (!table.visible[row] || table.opacity[row] <= 0.0f) continue;
+                addBox(table.position[row], table.size[row], table.color[row], table.opacity[row], fogRange);
+            }
+        });
+
+        for (const auto& obj : objects) {
+            if (!obj->isVisible() || obj->opacity() <= 0.0f) continue;
+
+            for (int instance = 0; instance < obj->instanceCount(); ++instance) {
+                addBox(obj->instancePosition(instance), obj->size(), obj->color(), obj->opacity(), fogRange);
+            }
+        }
+
+        buildGrid();
+    }
+
+    /**
+     * Upload the scene and bind the buffers for the shader.
+     */
+    void upload() {
+        gpuBoxes.resize(boxes.size());
+        for (size_t b = 0; b < boxes.size(); ++b) {
+            const Box& box = boxes[b];
+            GpuBox& gpu = gpuBoxes[b];
+            gpu.center = glm::vec4(box.center[0], box.center[1], box.center[2], box.center[3]);
+            gpu.halfSize = glm::vec4(box.halfSize[0], box.halfSize[1], box.halfSize[2], box.halfSize[3]);
+            gpu.extra = glm::vec4(box.center[4], box.halfSize[4], 0.0f, 0.0f);
+            gpu.colorOpacity = glm::vec4(box.color, box.opacity);
+        }
+
+        // Sizes change with the level and slice, so the buffers are respecified
+        uploadBuffer(boxSSBO, gpuBoxes);
+        uploadBuffer(cellSSBO, cells);
+        uploadBuffer(indexSSBO, cellBoxes);
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, boxSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, cellSSBO);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, indexSSBO);
+    }
+
+    /**
+     * One fullscreen triangle; the vertex shader makes the positions.
+     */
+    void drawFullscreen() const {
+        glBindVertexArray(fullscreenVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+    }
+
+    int cellCount() const {
+        return gridDims.x * gridDims.y * gridDims.z;
+    }
+
+    /**
+     * Trace one ray and return its color.
+     */
+    glm::vec3 traceRay(const glm::vec3& origin, const glm::vec3& dir, const glm::vec3& lightPos) const {
+        glm::vec3 fogColor(0.0f);
+        float fogAlpha = 0.0f;
+
+        float tEnter, tExit;
+        if (cellCount() == 0 || !intersectGrid(origin, dir, tEnter, tExit)) {
+            return background;
+        }
+
+        // 3D DDA setup
+        glm::vec3 start = origin + dir * tEnter;
+        glm::ivec3 cell, step;
+        glm::vec3 tMax, tDelta;
+        for (int a = 0; a < 3; ++a) {
+            cell[a] = std::clamp(static_cast<int>((start[a] - gridMin[a]) / cellSize[a]), 0, gridDims[a] - 1);
+            if (dir[a] > 0.0f) {
+                step[a] = 1;
+                tMax[a] = (gridMin[a] + (cell[a] + 1) * cellSize[a] - origin[a]) / dir[a];
+                tDelta[a] = cellSize[a] / dir[a];
+            } else if (dir[a] < 0.0f) {
+                step[a] = -1;
+                tMax[a] = (gridMin[a] + cell[a] * cellSize[a] - origin[a]) / dir[a];
+                tDelta[a] = -cellSize[a] / dir[a];
+            } else {
+                step[a] = 0;
+                tMax[a] = std::numeric_limits<float>::max();
+                tDelta[a] = std::numeric_limits<float>::max();
+            }
+        }
+
+        float t = tEnter;
+        int steps = 0;
+        while (steps < maxSteps && t < tExit) {
+            float cellExit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, tExit));
+            int c = (cell.z * gridDims.y + cell.y) * gridDims.x + cell.x;
+            uint32_t offset = cells[c * 2];
+            uint32_t count = cells[c * 2 + 1];
+
+            // Sphere-trace inside the cell; no step may leave it, since
+            // boxes listed in the next cell aren't known here
+            while (count > 0 && t < cellExit && steps < maxSteps) {
+                ++steps;
+                glm::vec3 p = origin + dir * t;
+                Sample sample = sample5D(p, offset, count);
+
+                if (sample.distance < hitEpsilon) {
+                    glm::vec3 surface = shade(p, dir, sample.box, lightPos);
+                    const Box& box = boxes[sample.box];
+                    glm::vec3 behind = glm::mix(background, surface, box.opacity);
+                    return fogColor + behind * (1.0f - fogAlpha);
+                }
+
+                float advance = std::max(sample.distance, hitEpsilon);
+                if (sample.fogDensity > 1e-3f) {
+                    advance = std::min(advance, fogStep);
+                    float a = 1.0f - std::exp(-sample.fogDensity * fogDensity * advance);
+                    fogColor += sample.fogColor * (a * (1.0f - fogAlpha));
+                    fogAlpha += a * (1.0f - fogAlpha);
+                }
+
+                if (t + advance >= cellExit) break;
+                t += advance;
+            }
+
+            t = cellExit;
+
+            // Step to the neighbouring cell
+            int axis = (tMax.x < tMax.y) ? ((tMax.x < tMax.z) ? 0 : 2) : ((tMax.y < tMax.z) ? 1 : 2);
+            cell[axis] += step[axis];
+            if (cell[axis] < 0 || cell[axis] >= gridDims[axis]) break;
+            tMax[axis] += tDelta[axis];
+        }
+
+        return fogColor + background * (1.0f - fogAlpha);
+    }
+
+    /**
+     * Render the slice on the CPU into an RGB8 image.
+     * The image is split into tiles that worker threads pull from a shared
+     * counter, so uneven tiles (sky vs. dense geometry) balance out.
+     */
+    void renderCPU(int width, int height, const glm::mat4& view, const glm::mat4& proj,
+                   const glm::vec3& lightPos, std::vector<uint8_t>& pixels,
+                   int threadCount = 0) const {
+        constexpr int TileSize = 16;
+
+        pixels.assign(static_cast<size_t>(width) * height * 3, 0);
+        glm::mat4 invViewProj = glm::inverse(proj * view);
+        glm::vec3 cameraPos = glm::vec3(glm::inverse(view)[3]);
+
+        int tilesX = (width + TileSize - 1) / TileSize;
+        int tilesY = (height + TileSize - 1) / TileSize;
+        int tileCount = tilesX * tilesY;
+        std::atomic<int> nextTile(0);
+
+        auto worker = [&]() {
+            for (int tile = nextTile++; tile < tileCount; tile = nextTile++) {
+                int x0 = (tile % tilesX) * TileSize;
+                int y0 = (tile / tilesX) * TileSize;
+                int x1 = std::min(x0 + TileSize, width);
+                int y1 = std::min(y0 + TileSize, height);
+
+                for (int y = y0; y < y1; ++y) {
+                    for (int x = x0; x < x1; ++x) {
+                        // Image rows run top-down, NDC y runs bottom-up
+                        glm::vec2 ndc((x + 0.5f) / width * 2.0f - 1.0f,
+                                      1.0f - (y + 0.5f) / height * 2.0f);
+                        glm::vec4 farPoint = invViewProj * glm::vec4(ndc, 1.0f, 1.0f);
+                        glm::vec3 dir = glm::normalize(glm::vec3(farPoint) / farPoint.w - cameraPos);
+
+                        glm::vec3 color = glm::clamp(traceRay(cameraPos, dir, lightPos), 0.0f, 1.0f);
+                        size_t index = (static_cast<size_t>(y) * width + x) * 3;
+                        pixels[index + 0] = static_cast<uint8_t>(color.r * 255.0f + 0.5f);
+                        pixels[index + 1] = static_cast<uint8_t>(color.g * 255.0f + 0.5f);
+                        pixels[index + 2] = static_cast<uint8_t>(color.b * 255.0f + 0.5f);
+                    }
+                }
+            }
+        };
+
+        if (threadCount <= 0) {
+            threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        threadCount = std::min(threadCount, tileCount);
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threadCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : workers) {
+            thread.join();
+        }
+    }
+
+private:
+    struct BoxBounds {
+        glm::vec3 min, max;
+    };
+
+    struct Sample {
+        float distance;
+        uint32_t box;
+        float fogDensity;
+        glm::vec3 fogColor;
+    };
+
+    GLuint boxSSBO, cellSSBO, indexSSBO;
+    GLuint fullscreenVAO;
+    std::vector<BoxBounds> boxBounds;
+    std::vector<GpuBox> gpuBoxes;
+    std::vector<uint32_t> cellCounts;
+
+    template<typename T>
+    static void uploadBuffer(GLuint buffer, const std::vector<T>& data) {
+        // Never zero-sized, so binding an empty scene is still valid
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        if (data.empty()) {
+            glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(T), NULL, GL_DYNAMIC_DRAW);
+        } else {
+            glBufferData(GL_SHADER_STORAGE_BUFFER, data.size() * sizeof(T), data.data(), GL_DYNAMIC_DRAW);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    /**
+     * Slice axes from the view rotation. The visible rows of the rotation
+     * span the slice; outside of view transitions the rotation is
+     * orthonormal and the pseudo-inverse is just the transpose.
+     */
+    void computeSlice(const DimensionState& dimState) {
+        Matrix5D rotation = dimState.getCurrentRotation();
+        const auto& dims = dimState.visibleDims;
+
+        for (int i = 0; i < 5; ++i) {
+            sliceRows[i] = glm::vec3(rotation.m[i][dims[0]], rotation.m[i][dims[1]], rotation.m[i][dims[2]]);
+        }
+
+        glm::mat3 gram(0.0f);
+        for (int i = 0; i < 5; ++i) {
+            gram += glm::outerProduct(sliceRows[i], sliceRows[i]);
+        }
+        glm::mat3 gramInverse = glm::inverse(gram);
+        for (int i = 0; i < 5; ++i) {
+            sliceProject[i] = gramInverse * sliceRows[i];
+        }
+    }
+
+    /**
+     * Add one box, unless it is too far from the slice to be seen.
+     */
+    void addBox(const Vec5D& center, const Vec5D& size, const glm::vec3& color, float opacity,
+                float fogRange) {
+        Box box;
+        for (int i = 0; i < 5; ++i) {
+            box.center[i] = center[i];
+            box.halfSize[i] = size[i] * 0.5f;
+        }
+        box.color = color;
+        box.opacity = opacity;
+
+        // Shadow of the box on the slice (contains its cross-section)
+        glm::vec3 sliceCenter(0.0f), sliceExtent(0.0f);
+        for (int i = 0; i < 5; ++i) {
+            sliceCenter += sliceProject[i] * box.center[i];
+            sliceExtent += glm::abs(sliceProject[i]) * box.halfSize[i];
+        }
+
+        // Skip boxes too deep in hidden dimensions to even cast fog:
+        // the center's distance from the slice minus the box radius
+        // is a lower bound on the hidden gap
+        float offSliceSq = 0.0f, radiusSq = 0.0f;
+        for (int i = 0; i < 5; ++i) {
+            float residual = box.center[i] - glm::dot(sliceRows[i], sliceCenter);
+            offSliceSq += residual * residual;
+            radiusSq += box.halfSize[i] * box.halfSize[i];
+        }
+        if (std::sqrt(offSliceSq) - std::sqrt(radiusSq) > fogRange) return;
+
+        BoxBounds bounds;
+        bounds.min = sliceCenter - sliceExtent - glm::vec3(fogEdge);
+        bounds.max = sliceCenter + sliceExtent + glm::vec3(fogEdge);
+        boxBounds.push_back(bounds);
+        boxes.push_back(box);
+    }
+
+    /**
+     * Bin boxes into a grid sized for a few boxes per cell.
+     */
+    void buildGrid() {
+        if (boxes.empty()) {
+            gridDims = glm::ivec3(0);
+            cells.clear();
+            cellBoxes.clear();
+            return;
+        }
+
+        // Bounds of everything, kept within a sane distance of the camera
+        glm::vec3 lo(std::numeric_limits<float>::max());
+        glm::vec3 hi(-std::numeric_limits<float>::max());
+        for (const BoxBounds& bounds : boxBounds) {
+            lo = glm::min(lo, bounds.min);
+            hi = glm::max(hi, bounds.max);
+        }
+        lo = glm::max(lo, glm::vec3(-500.0f));
+        hi = glm::min(hi, glm::vec3(500.0f));
+        glm::vec3 extent = glm::max(hi - lo, glm::vec3(1.0f));
+
+        float targetCells = static_cast<float>(boxes.size()) * 4.0f;
+        float side = std::cbrt(extent.x * extent.y * extent.z / targetCells);
+        for (int a = 0; a < 3; ++a) {
+            gridDims[a] = std::clamp(static_cast<int>(std::ceil(extent[a] / side)), 1, MaxGridDim);
+        }
+        gridMin = lo;
+        cellSize = extent / glm::vec3(gridDims);
+
+        // Same two-pass count / prefix sum / scatter as the light clusters
+        int count = cellCount();
+        cellCounts.assign(count, 0u);
+        forEachCell([&](uint32_t, int c) { ++cellCounts[c]; });
+
+        cells.resize(count * 2);
+        uint32_t offset = 0;
+        for (int c = 0; c < count; ++c) {
+            cells[c * 2] = offset;
+            cells[c * 2 + 1] = 0;
+            offset += cellCounts[c];
+        }
+
+        cellBoxes.resize(offset);
+        forEachCell([&](uint32_t box, int c) {
+            cellBoxes[cells[c * 2] + cells[c * 2 + 1]++] = box;
+        });
+    }
+
+    template<typename Fn>
+    void forEachCell(Fn&& fn) const {
+        for (uint32_t b = 0; b < boxBounds.size(); ++b) {
+            glm::ivec3 c0 = cellCoord(boxBounds[b].min);
+            glm::ivec3 c1 = cellCoord(boxBounds[b].max);
+            for (int z = c0.z; z <= c1.z; ++z)
+                for (int y = c0.y; y <= c1.y; ++y)
+                    for (int x = c0.x; x <= c1.x; ++x)
+                        fn(b, (z * gridDims.y + y) * gridDims.x + x);
+        }
+    }
+
+    glm::ivec3 cellCoord(const glm::vec3& p) const {
+        glm::ivec3 coord;
+        for (int a = 0; a < 3; ++a) {
+            coord[a] = std::clamp(static_cast<int>(std::floor((p[a] - gridMin[a]) / cellSize[a])),
+                                  0, gridDims[a] - 1);
+        }
+        return coord;
+    }
+
+    bool intersectGrid(const glm::vec3& origin, const glm::vec3& dir, float& tEnter, float& tExit) const {
+        glm::vec3 gridMax = gridMin + cellSize * glm::vec3(gridDims);
+        tEnter = 0.0f;
+        tExit = std::numeric_limits<float>::max();
+        for (int a = 0; a < 3; ++a) {
+            if (std::abs(dir[a]) < 1e-8f) {
+                if (origin[a] < gridMin[a] || origin[a] > gridMax[a]) return false;
+                continue;
+            }
+            float t0 = (gridMin[a] - origin[a]) / dir[a];
+            float t1 = (gridMax[a] - origin[a]) / dir[a];
+            if (t0 > t1) std::swap(t0, t1);
+            tEnter = std::max(tEnter, t0);
+            tExit = std::min(tExit, t1);
+        }
+        return tEnter < tExit;
+    }
+
+    /**
+     * Distance to the nearest box of a cell and the hidden-dimension fog at p.
+     */
+    Sample sample5D(const glm::vec3& p, uint32_t offset, uint32_t count) const {
+        float w[5];
+        for (int i = 0; i < 5; ++i) {
+            w[i] = glm::dot(sliceRows[i], p);
+        }
+
+        Sample sample = {std::numeric_limits<float>::max(), 0, 0.0f, glm::vec3(0.0f)};
+        for (uint32_t k = 0; k < count; ++k) {
+            uint32_t b = cellBoxes[offset + k];
+            const Box& box = boxes[b];
+
+            float outsideSq = 0.0f, inside = -std::numeric_limits<float>::max();
+            glm::vec3 onSlice(0.0f);
+            for (int i = 0; i < 5; ++i) {
+                float local = w[i] - box.center[i];
+                float q = std::abs(local) - box.halfSize[i];
+                inside = std::max(inside, q);
+                if (q > 0.0f) {
+                    outsideSq += q * q;
+                    onSlice += sliceProject[i] * std::copysign(q, local);
+                }
+            }
+
+            float outside = std::sqrt(outsideSq);
+            float distance = outside + std::min(inside, 0.0f);
+            if (distance < sample.distance) {
+                sample.distance = distance;
+                sample.box = b;
+            }
+
+            // Fog fills the box's shadow on the slice, fading with the gap
+            // in hidden dimensions; boxes cut by the slice cast none
+            if (outside > 0.0f) {
+                float sliceDist = glm::length(onSlice);
+                float hiddenDist = std::sqrt(std::max(outsideSq - sliceDist * sliceDist, 0.0f));
+                float density = std::exp(-hiddenDist / fogFalloff)
+                              * std::clamp(1.0f - sliceDist / fogEdge, 0.0f, 1.0f)
+                              * std::clamp(hiddenDist / fogEdge, 0.0f, 1.0f);
+                sample.fogDensity += density;
+                sample.fogColor += box.color * density;
+            }
+        }
+
+        if (sample.fogDensity > 0.0f) {
+            sample.fogColor /= sample.fogDensity;
+        }
+        return sample;
+    }
+
+    /**
+     * Lambert shading with the box's analytic 5D gradient pulled back
+     * onto the slice as the normal.
+     */
+    glm::vec3 shade(const glm::vec3& p, const glm::vec3& dir, uint32_t b, const glm::vec3& lightPos) const {
+        const Box& box = boxes[b];
+
+        float local[5], q[5];
+        int maxAxis = 0;
+        bool outside = false;
+        for (int i = 0; i < 5; ++i) {
+            local[i] = glm::dot(sliceRows[i], p) - box.center[i];
+            q[i] = std::abs(local[i]) - box.halfSize[i];
+            if (q[i] > q[maxAxis]) maxAxis = i;
+            if (q[i] > 0.0f) outside = true;
+        }
+
+        glm::vec3 normal(0.0f);
+        for (int i = 0; i < 5; ++i) {
+            float g = outside ? std::max(q[i], 0.0f) : (i == maxAxis ? 1.0f : 0.0f);
+            normal += sliceRows[i] * std::copysign(g, local[i]);
+        }
+        normal = glm::length(normal) > 1e-6f ? glm::normalize(normal) : -dir;
+
+        glm::vec3 toLight = glm::normalize(lightPos - p);
+        float diffuse = std::max(glm::dot(normal, toLight), 0.0f);
+        return box.color * (0.3f + 0.7f * diffuse);
+    }
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include "../core/Transform5D.hpp"
+#include <vector>
+#include <cstdint>
+
+/**
+ * SceneGraph5D - Parent/child transforms for objects that move as a unit
+ *
+ * Nodes live in flat arrays in depth-first order: a node's descendants
+ * follow it directly, up to its subtreeEnd. Every parent therefore comes
+ * before its children, and world transforms update in one forward pass.
+ *
+ * Changing a node's local transform marks it dirty. update() walks the
+ * array, steps over clean nodes with a flag check, and recomputes each
+ * dirty node's subtree as one run. A node can carry an object; the object
+ * is placed at the node's world origin and its size scaled by the node's
+ * world transform, moving from where it was (previousPosition) for
+ * render interpolation.
+ *
+ * Node ids don't change when nodes are inserted in front of them; only
+ * their place in the arrays does.
+ */
+class SceneGraph5D {
+public:
+    static constexpr int Root = -1;
+
+    // Nodes recomputed by the last update (for the debug UI)
+    int lastUpdated;
+
+    SceneGraph5D()
+        : lastUpdated(0)
+        , dirtyCount(0)
+    {}
+
+    void clear() {
+        local.clear();
+        world.clear();
+        parent.clear();
+        subtreeEnd.clear();
+        object.clear();
+        objectSize.clear();
+        dirty.clear();
+        indexOfNode.clear();
+        moved.clear();
+        dirtyCount = 0;
+        lastUpdated = 0;
+    }
+
+    /**
+     * Add a node as the last child of parent (or at the top with Root),
+     * optionally carrying an object. Returns the new node's id. The
+     * object's current size is taken as its size in node space.
+     */
+    int addNode(int parentNode, const Transform5D& transform, GameObject5D* obj = nullptr) {
+        int parentIndex = parentNode == Root ? -1 : indexOfNode[parentNode];
+        int at = parentIndex < 0 ? size() : subtreeEnd[parentIndex];
+
+        // Make room at the end of the parent's subtree
+        for (int i = 0; i < size(); ++i) {
+            if (subtreeEnd[i] > at) ++subtreeEnd[i];
+            if (parent[i] >= at) ++parent[i];
+        }
+        for (int& index : indexOfNode) {
+            if (index >= at) ++index;
+        }
+        for (int p = parentIndex; p >= 0; p = parent[p]) {
+            if (subtreeEnd[p] == at) ++subtreeEnd[p];
+        }
+
+        int id = static_cast<int>(indexOfNode.size());
+        indexOfNode.push_back(at);
+        local.insert(local.begin() + at, transform);
+        world.insert(world.begin() + at, transform);
+        parent.insert(parent.begin() + at, parentIndex);
+        subtreeEnd.insert(subtreeEnd.begin() + at, at + 1);
+        object.insert(object.begin() + at, obj);
+        objectSize.insert(objectSize.begin() + at, obj ? obj->size() : Vec5D());
+        dirty.insert(dirty.begin() + at, 1);
+        ++dirtyCount;
+
+        if (obj) obj->sceneNode = id;
+        return id;
+    }
+
+    void setLocal(int node, const Transform5D& transform) {
+        int i = indexOfNode[node];
+        local[i] = transform;
+        if (!dirty[i]) {
+            dirty[i] = 1;
+            ++dirtyCount;
+        }
+    }
+
+    const Transform5D& getLocal(int node) const {
+        return local[indexOfNode[node]];
+    }
+
+    /**
+     * World transform as of the last update().
+     */
+    const Transform5D& getWorld(int node) const {
+        return world[indexOfNode[node]];
+    }
+
+    /**
+     * Stop moving an object (it is leaving the level). Its node stays.
+     */
+    void unbind(GameObject5D* obj) {
+        if (obj->sceneNode < 0) return;
+        object[indexOfNode[obj->sceneNode]] = nullptr;
+        obj->sceneNode = -1;
+    }
+
+    /**
+     * Recompute the world transforms of dirty subtrees and move their
+     * objects. onMoved(GameObject5D*) is called for each moved object.
+     */
+    template<typename Fn>
+    void update(Fn&& onMoved) {
+        lastUpdated = 0;
+        moved.clear();
+        if (dirtyCount == 0) return;
+
+        int count = size();
+        for (int i = 0; i < count;) {
+            if (!dirty[i]) {
+                ++i;
+                continue;
+            }
+            int end = subtreeEnd[i];
+            for (int j = i; j < end; ++j) {
+                world[j] = parent[j] < 0 ? local[j] : world[parent[j]] * local[j];
+                dirty[j] = 0;
+                ++lastUpdated;
+
+                if (GameObject5D* obj = object[j]) {
+                    obj->previousPosition() = obj->position();
+                    obj->position() = world[j].translation;
+                    obj->size() = world[j].transformExtent(objectSize[j]);
+                    obj->updateBounds();
+                    moved.push_back(obj->sceneNode);
+                    onMoved(obj);
+                }
+            }
+            i = end;
+        }
+        dirtyCount = 0;
+    }
+
+    /**
+     * Bring the objects moved by the last update() to rest: their previous
+     * position catches up with where they are. Called at the start of a
+     * step, before anything moves again.
+     */
+    void settle() {
+        for (int node : moved) {
+            if (GameObject5D* obj = object[indexOfNode[node]]) {
+                obj->previousPosition() = obj->position();
+            }
+        }
+    }
+
+    int size() const {
+        return static_cast<int>(local.size());
+    }
+
+private:
+    // Per node, in depth-first order
+    std::vector<Transform5D> local;
+    std::vector<Transform5D> world;
+    std::vector<int> parent;        // Index of the parent, -1 at the top
+    std::vector<int> subtreeEnd;    // One past the node's last descendant
+    std::vector<GameObject5D*> object;
+    std::vector<Vec5D> objectSize;  // Object size in node space
+    std::vector<uint8_t> dirty;
+
+    std::vector<int> indexOfNode;   // Node id -> place in the arrays
+    std::vector<int> moved;         // Nodes whose object the last update moved
+    int dirtyCount;
+};
@@ -0,0 +1,318 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * SpatialHash5D - Uniform 5D grid stored in an open-addressing hash table
+ *
+ * Meant for short-lived, fast objects (boss projectiles) where keeping a
+ * sorted structure up to date costs more than starting over: the whole
+ * index is rebuilt every frame in O(n).
+ *
+ * Each body goes into the one cell holding its center. Cells are twice as
+ * wide as the largest body, so a body's box plus the largest half-extent
+ * spans at most two cells per axis: a box query touches at most 2^5 = 32
+ * cells, and a neighbourhood query never needs more than the 3^5 = 243
+ * cells around a point. Most of those are empty; an occupancy mask per axis
+ * drops whole rows of them before the table is even probed.
+ *
+ * Rebuild is a counting sort: count bodies per cell, prefix-sum into
+ * offsets, then scatter into one contiguous body array.
+ */
+class SpatialHash5D {
+public:
+    float minCellSize;          // Cells are never smaller than this
+    float cellSize;             // Cell size chosen by the last build
+
+    SpatialHash5D()
+        : minCellSize(1.0f)
+        , cellSize(1.0f)
+        , cellCount(0)
+        , hashShift(58)
+        , maxHalfExtent(0.0f)
+    {
+        clearOccupancy();
+    }
+
+    /**
+     * Rebuild the index from scratch.
+     */
+    void build(const std::vector<GameObject5D*>& objects) {
+        bodies.clear();
+        bodyCells.resize(objects.size());
+        clearOccupancy();
+
+        // Cell size from the largest body (see class comment)
+        maxHalfExtent = 0.0f;
+        for (const GameObject5D* obj : objects) {
+            for (int i = 0; i < 5; ++i) {
+                maxHalfExtent = std::max(maxHalfExtent, obj->size()[i] * 0.5f);
+            }
+        }
+        cellSize = std::max(minCellSize, maxHalfExtent * 4.0f);
+
+        // Table at most half full, power of two
+        size_t capacity = 64;
+        hashShift = 58;
+        while (capacity < objects.size() * 2) {
+            capacity *= 2;
+            --hashShift;
+        }
+        slots.assign(capacity, Slot{EmptyKey, 0, 0});
+        cellCount = 0;
+
+        // Pass 1: find each body's cell and count
+        for (size_t b = 0; b < objects.size(); ++b) {
+            Cell cell = cellOf(objects[b]->position());
+            markOccupied(cell);
+            Slot& slot = findOrInsert(packKey(cell));
+            ++slot.count;
+            bodyCells[b] = static_cast<uint32_t>(&slot - slots.data());
+        }
+
+        // Prefix sum over occupied slots
+        uint32_t offset = 0;
+        for (Slot& slot : slots) {
+            if (slot.key == EmptyKey) continue;
+            slot.start = offset;
+            offset += slot.count;
+            slot.count = 0;
+        }
+
+        // Pass 2: scatter
+        bodies.resize(objects.size());
+        for (size_t b = 0; b < objects.size(); ++b) {
+            Slot& slot = slots[bodyCells[b]];
+            bodies[slot.start + slot.count++] = objects[b];
+        }
+    }
+
+    /**
+     * Visit every body whose cell could hold something overlapping the box.
+     */
+    template<typename Fn>
+    void queryBox(const Vec5D& boxMin, const Vec5D& boxMax, Fn&& fn) const {
+        if (bodies.empty()) return;
+
+        // A body's center is at most maxHalfExtent outside the box it overlaps
+        Vec5D margin(maxHalfExtent, maxHalfExtent, maxHalfExtent, maxHalfExtent, maxHalfExtent);
+        visitRange(cellOf(boxMin - margin), cellOf(boxMax + margin), [&](const Slot& slot) {
+            for (uint32_t k = 0; k < slot.count; ++k) {
+                fn(bodies[slot.start + k]);
+            }
+        });
+    }
+
+    /**
+     * Visit the bodies in the 3^5 cells around a point.
+     */
+    template<typename Fn>
+    void queryNeighbors(const Vec5D& point, Fn&& fn) const {
+        if (bodies.empty()) return;
+
+        Cell center = cellOf(point);
+        Cell lo, hi;
+        for (int i = 0; i < 5; ++i) {
+            lo.c[i] = center.c[i] - 1;
+            hi.c[i] = center.c[i] + 1;
+        }
+        visitRange(lo, hi, [&](const Slot& slot) {
+            for (uint32_t k = 0; k < slot.count; ++k) {
+                fn(bodies[slot.start + k]);
+            }
+        });
+    }
+
+    /**
+     * Visit each pair of bodies whose boxes overlap, once.
+     */
+    template<typename Fn>
+    void forEachPair(Fn&& fn) const {
+        for (GameObject5D* body : bodies) {
+            Vec5D bodyMin, bodyMax;
+            body->getBounds(bodyMin, bodyMax);
+            queryBox(bodyMin, bodyMax, [&](GameObject5D* other) {
+                if (other > body && body->intersects(*other)) {
+                    fn(body, other);
+                }
+            });
+        }
+    }
+
+    int getBodyCount() const {
+        return static_cast<int>(bodies.size());
+    }
+
+    int getCellCount() const {
+        return cellCount;
+    }
+
+    /**
+     * Bytes held by the index (table, bodies and scratch).
+     */
+    size_t memoryBytes() const {
+        return slots.capacity() * sizeof(Slot)
+             + bodies.capacity() * sizeof(GameObject5D*)
+             + bodyCells.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr uint64_t EmptyKey = ~0ull;
+    static constexpr int CoordBits = 12;
+    static constexpr int CoordLimit = 1 << (CoordBits - 1);
+
+    struct Cell {
+        int c[5];
+    };
+
+    struct Slot {
+        uint64_t key;
+        uint32_t start;
+        uint32_t count;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<GameObject5D*> bodies;
+    std::vector<uint32_t> bodyCells;      // Slot of each body during a build
+    uint64_t occupied[5];                 // Bit (coord & 63) set if any body has it
+    int cellCount;
+    int hashShift;                        // 64 - log2(table size)
+    float maxHalfExtent;
+
+    Cell cellOf(const Vec5D& p) const {
+        Cell cell;
+        for (int i = 0; i < 5; ++i) {
+            int c = static_cast<int>(std::floor(p[i] / cellSize));
+            cell.c[i] = std::clamp(c, -CoordLimit, CoordLimit - 1);
+        }
+        return cell;
+    }
+
+    static Cell unpackKey(uint64_t key) {
+        Cell cell;
+        for (int i = 4; i >= 0; --i) {
+            cell.c[i] = static_cast<int>(key & ((1u << CoordBits) - 1)) - CoordLimit;
+            key >>= CoordBits;
+        }
+        return cell;
+    }
+
+    static uint64_t packKey(const Cell& cell) {
+        uint64_t key = 0;
+        for (int i = 0; i < 5; ++i) {
+            key = (key << CoordBits) | static_cast<uint64_t>(cell.c[i] + CoordLimit);
+        }
+        return key;
+    }
+
+    size_t slotIndex(uint64_t key) const {
+        // Fibonacci hashing: the top bits of the product are the best mixed
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> hashShift);
+    }
+
+    Slot& findOrInsert(uint64_t key) {
+        size_t mask = slots.size() - 1;
+        for (size_t i = slotIndex(key);; i = (i + 1) & mask) {
+            if (slots[i].key == key) return slots[i];
+            if (slots[i].key == EmptyKey) {
+                slots[i].key = key;
+                ++cellCount;
+                return slots[i];
+            }
+        }
+    }
+
+    const Slot* find(uint64_t key) const {
+        size_t mask = slots.size() - 1;
+        for (size_t i = slotIndex(key);; i = (i + 1) & mask) {
+            if (slots[i].key == key) return &slots[i];
+            if (slots[i].key == EmptyKey) return nullptr;
+        }
+    }
+
+    void clearOccupancy() {
+        for (uint64_t& mask : occupied) mask = 0;
+    }
+
+    void markOccupied(const Cell& cell) {
+        for (int i = 0; i < 5; ++i) {
+            occupied[i] |= 1ull << (cell.c[i] & 63);
+        }
+    }
+
+    bool mayBeOccupied(int axis, int coord) const {
+        return (occupied[axis] >> (coord & 63)) & 1ull;
+    }
+
+    /**
+     * Range walk for huge ranges: test every occupied cell instead.
+     */
+    template<typename Fn>
+    void visitRangeByScan(const Cell& lo, const Cell& hi, Fn& fn) const {
+        for (const Slot& slot : slots) {
+            if (slot.key == EmptyKey) continue;
+            Cell cell = unpackKey(slot.key);
+            bool inside = true;
+            for (int i = 0; i < 5 && inside; ++i) {
+                inside = cell.c[i] >= lo.c[i] && cell.c[i] <= hi.c[i];
+            }
+            if (inside) fn(slot);
+        }
+    }
+
+    /**
+     * Call fn for each occupied cell in a range.
+     *
+     * Coordinates that no body has are dropped per axis up front, so a
+     * mostly empty neighbourhood costs a handful of probes rather than one
+     * per cell. The packed key is linear in the coordinates, which lets the
+     * loops build keys by addition.
+     */
+    template<typename Fn>
+    void visitRange(const Cell& lo, const Cell& hi, Fn&& fn) const {
+        constexpr int MaxSpan = 64;
+        uint64_t axisKeys[5][MaxSpan];
+        int axisCount[5];
+
+        for (int i = 0; i < 5; ++i) {
+            if (hi.c[i] - lo.c[i] >= MaxSpan) {
+                visitRangeByScan(lo, hi, fn);
+                return;
+            }
+        }
+
+        for (int i = 0; i < 5; ++i) {
+            int shift = CoordBits * (4 - i);
+            int first = std::max(lo.c[i], -CoordLimit);
+            int last = std::min(hi.c[i], CoordLimit - 1);
+            axisCount[i] = 0;
+            for (int c = first; c <= last; ++c) {
+                if (!mayBeOccupied(i, c)) continue;
+                axisKeys[i][axisCount[i]++] = static_cast<uint64_t>(c + CoordLimit) << shift;
+            }
+            if (axisCount[i] == 0) return;
+        }
+
+        for (int a = 0; a < axisCount[0]; ++a) {
+            for (int b = 0; b < axisCount[1]; ++b) {
+                uint64_t keyAB = axisKeys[0][a] | axisKeys[1][b];
+                for (int c = 0; c < axisCount[2]; ++c) {
+                    uint64_t keyABC = keyAB | axisKeys[2][c];
+                    for (int d = 0; d < axisCount[3]; ++d) {
+                        uint64_t keyABCD = keyABC | axisKeys[3][d];
+                        for (int e = 0; e < axisCount[4]; ++e) {
+                            if (const Slot* slot = find(keyABCD | axisKeys[4][e])) {
+                                fn(*slot);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
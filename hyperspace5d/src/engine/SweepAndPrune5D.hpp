@@ -0,0 +1,429 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * SweepAndPrune5D - Incremental sweep-and-prune broadphase over 5D AABBs
+ *
+ * Every proxy has a min and max endpoint on each of the five axes, and each
+ * axis keeps its endpoints sorted. When a proxy moves, its endpoints are
+ * moved with insertion sort; objects barely move between frames, so each
+ * update only swaps with a few neighbours.
+ *
+ * Swaps are what change overlap: a min passing another proxy's max starts
+ * an overlap on that axis, a max passing a min ends one. On a start the
+ * full 5D boxes are tested and the pair is recorded if they overlap on all
+ * axes; on an end the pair is dropped. Each proxy keeps the list of proxies
+ * it currently overlaps, so queries never touch non-overlapping objects.
+ *
+ * Moving proxies are stored with a small margin and only re-sorted once
+ * the object leaves its enlarged box.
+ */
+class SweepAndPrune5D {
+public:
+    struct Proxy {
+        GameObject5D* object;
+        Vec5D min;
+        Vec5D max;
+        uint32_t minIndex[5];       // Position of our endpoints on each axis
+        uint32_t maxIndex[5];
+        std::vector<int> overlaps;  // Proxies whose boxes overlap ours
+        bool alive;
+    };
+
+    std::vector<Proxy> proxies;
+    float margin;                   // Padding on moving proxies
+
+    // Work done by the last update (for the debug UI)
+    int lastSwaps;
+    int lastMoved;
+
+    SweepAndPrune5D()
+        : margin(0.2f)
+        , lastSwaps(0)
+        , lastMoved(0)
+        , pairCount(0)
+        , built(false)
+    {}
+
+    void clear() {
+        proxies.clear();
+        freeProxies.clear();
+        proxyOf.clear();
+        for (auto& axis : endpoints) axis.clear();
+        pairCount = 0;
+        built = false;
+    }
+
+    bool isBuilt() const {
+        return built;
+    }
+
+    /**
+     * Add an object. With sortNow false the proxy is only appended and the
+     * next rebuild() sorts everything at once (used when loading a level).
+     */
+    int addProxy(GameObject5D* object, bool sortNow = true) {
+        int id;
+        if (!freeProxies.empty()) {
+            id = freeProxies.back();
+            freeProxies.pop_back();
+        } else {
+            id = static_cast<int>(proxies.size());
+            proxies.emplace_back();
+        }
+
+        Proxy& proxy = proxies[id];
+        proxy.object = object;
+        proxy.overlaps.clear();
+        proxy.alive = true;
+        fitBounds(proxy);
+        proxyOf[object] = id;
+
+        for (int axis = 0; axis < 5; ++axis) {
+            std::vector<Endpoint>& list = endpoints[axis];
+            proxy.minIndex[axis] = static_cast<uint32_t>(list.size());
+            list.push_back({proxy.min[axis], makeData(id, false)});
+            proxy.maxIndex[axis] = static_cast<uint32_t>(list.size());
+            list.push_back({proxy.max[axis], makeData(id, true)});
+
+            // Appended at the far end: the min passing other maxes records
+            // the overlaps, the max passing mins drops the ones that end
+            if (sortNow) {
+                sortDown(axis, proxy.minIndex[axis]);
+                sortDown(axis, proxy.maxIndex[axis]);
+            }
+        }
+        return id;
+    }
+
+    void removeProxy(int id) {
+        Proxy& proxy = proxies[id];
+        if (!proxy.alive) return;
+
+        while (!proxy.overlaps.empty()) {
+            removePair(id, proxy.overlaps.back());
+        }
+
+        for (int axis = 0; axis < 5; ++axis) {
+            std::vector<Endpoint>& list = endpoints[axis];
+            uint32_t first = proxy.minIndex[axis];
+            uint32_t second = proxy.maxIndex[axis];
+            if (first > second) std::swap(first, second);
+            list.erase(list.begin() + second);
+            list.erase(list.begin() + first);
+            for (uint32_t i = first; i < list.size(); ++i) {
+                setIndex(axis, i);
+            }
+        }
+
+        proxyOf.erase(proxy.object);
+        proxy.object = nullptr;
+        proxy.alive = false;
+        freeProxies.push_back(id);
+    }
+
+    void removeObject(const GameObject5D* object) {
+        auto it = proxyOf.find(object);
+        if (it != proxyOf.end()) {
+            removeProxy(it->second);
+        }
+    }
+
+    int findProxy(const GameObject5D* object) const {
+        auto it = proxyOf.find(object);
+        return (it != proxyOf.end()) ? it->second : -1;
+    }
+
+    /**
+     * Sort all axes from scratch and find every overlapping pair with a
+     * single sweep along X.
+     */
+    void rebuild() {
+        pairCount = 0;
+        for (Proxy& proxy : proxies) {
+            proxy.overlaps.clear();
+        }
+
+        for (int axis = 0; axis < 5; ++axis) {
+            std::vector<Endpoint>& list = endpoints[axis];
+            std::sort(list.begin(), list.end(), endpointLess);
+            for (uint32_t i = 0; i < list.size(); ++i) {
+                setIndex(axis, i);
+            }
+        }
+
+        std::vector<int> active;
+        std::vector<int> activeSlot(proxies.size(), -1);
+        for (const Endpoint& endpoint : endpoints[0]) {
+            int id = proxyId(endpoint);
+            if (!isMax(endpoint)) {
+                for (int other : active) {
+                    if (boxesOverlap(proxies[id], proxies[other])) {
+                        addPair(id, other);
+                    }
+                }
+                activeSlot[id] = static_cast<int>(active.size());
+                active.push_back(id);
+            } else {
+                int slot = activeSlot[id];
+                activeSlot[active.back()] = slot;
+                active[slot] = active.back();
+                active.pop_back();
+            }
+        }
+
+        built = true;
+    }
+
+    /**
+     * Refresh one proxy from its object. Returns true if it was re-sorted.
+     */
+    bool updateProxy(int id) {
+        Vec5D tightMin, tightMax;
+        proxies[id].object->getBounds(tightMin, tightMax);
+        return updateProxy(id, tightMin, tightMax);
+    }
+
+    /**
+     * Make one proxy cover a given box, e.g. the whole path an object
+     * sweeps this step. Returns true if it was re-sorted.
+     */
+    bool updateProxy(int id, const Vec5D& tightMin, const Vec5D& tightMax) {
+        Proxy& proxy = proxies[id];
+
+        bool inside = true;
+        for (int i = 0; i < 5; ++i) {
+            if (tightMin[i] < proxy.min[i] || tightMax[i] > proxy.max[i]) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) return false;
+
+        Vec5D oldMin = proxy.min;
+        Vec5D oldMax = proxy.max;
+        fitBounds(proxy, tightMin, tightMax);
+
+        for (int axis = 0; axis < 5; ++axis) {
+            std::vector<Endpoint>& list = endpoints[axis];
+            list[proxy.minIndex[axis]].value = proxy.min[axis];
+            list[proxy.maxIndex[axis]].value = proxy.max[axis];
+
+            // Grow first, then shrink
+            if (proxy.min[axis] < oldMin[axis]) sortDown(axis, proxy.minIndex[axis]);
+            if (proxy.max[axis] > oldMax[axis]) sortUp(axis, proxy.maxIndex[axis]);
+            if (proxy.min[axis] > oldMin[axis]) sortUp(axis, proxy.minIndex[axis]);
+            if (proxy.max[axis] < oldMax[axis]) sortDown(axis, proxy.maxIndex[axis]);
+        }
+        ++lastMoved;
+        return true;
+    }
+
+    /**
+     * Refresh every non-static proxy (moving platforms, projectiles, ...).
+     */
+    void update() {
+        lastSwaps = 0;
+        lastMoved = 0;
+        for (int id = 0; id < static_cast<int>(proxies.size()); ++id) {
+            if (proxies[id].alive && !proxies[id].object->isStatic) {
+                updateProxy(id);
+            }
+        }
+    }
+
+    /**
+     * Refresh only the proxies of the given objects (the ones that may
+     * have moved); objects without a proxy are skipped.
+     */
+    void update(const std::vector<GameObject5D*>& objects) {
+        lastSwaps = 0;
+        lastMoved = 0;
+        for (GameObject5D* object : objects) {
+            int id = findProxy(object);
+            if (id >= 0) {
+                updateProxy(id);
+            }
+        }
+    }
+
+    const std::vector<int>& overlaps(int id) const {
+        return proxies[id].overlaps;
+    }
+
+    GameObject5D* object(int id) const {
+        return proxies[id].object;
+    }
+
+    int getPairCount() const {
+        return pairCount;
+    }
+
+    int getProxyCount() const {
+        return static_cast<int>(proxies.size() - freeProxies.size());
+    }
+
+    /**
+     * Visit each overlapping pair once.
+     */
+    template<typename Fn>
+    void forEachPair(Fn&& fn) const {
+        for (int id = 0; id < static_cast<int>(proxies.size()); ++id) {
+            for (int other : proxies[id].overlaps) {
+                if (id < other) fn(proxies[id].object, proxies[other].object);
+            }
+        }
+    }
+
+private:
+    struct Endpoint {
+        float value;
+        uint32_t data;          // proxy id << 1 | isMax
+    };
+
+    std::vector<Endpoint> endpoints[5];
+    std::vector<int> freeProxies;
+    std::unordered_map<const GameObject5D*, int> proxyOf;
+    int pairCount;
+    bool built;
+
+    static uint32_t makeData(int id, bool max) {
+        return (static_cast<uint32_t>(id) << 1) | (max ? 1u : 0u);
+    }
+
+    static int proxyId(const Endpoint& endpoint) {
+        return static_cast<int>(endpoint.data >> 1);
+    }
+
+    static bool isMax(const Endpoint& endpoint) {
+        return (endpoint.data & 1u) != 0;
+    }
+
+    /**
+     * Endpoint order. Mins go before maxes on ties so touching boxes count
+     * as overlapping, the same as boxesOverlap().
+     */
+    static bool endpointLess(const Endpoint& a, const Endpoint& b) {
+        if (a.value != b.value) return a.value < b.value;
+        return !isMax(a) && isMax(b);
+    }
+
+    void fitBounds(Proxy& proxy) const {
+        Vec5D tightMin, tightMax;
+        proxy.object->getBounds(tightMin, tightMax);
+        fitBounds(proxy, tightMin, tightMax);
+    }
+
+    void fitBounds(Proxy& proxy, const Vec5D& tightMin, const Vec5D& tightMax) const {
+        proxy.min = tightMin;
+        proxy.max = tightMax;
+        if (!proxy.object->isStatic) {
+            for (int i = 0; i < 5; ++i) {
+                proxy.min[i] -= margin;
+                proxy.max[i] += margin;
+            }
+        }
+    }
+
+    void setIndex(int axis, uint32_t i) {
+        const Endpoint& endpoint = endpoints[axis][i];
+        Proxy& proxy = proxies[proxyId(endpoint)];
+        if (isMax(endpoint)) {
+            proxy.maxIndex[axis] = i;
+        } else {
+            proxy.minIndex[axis] = i;
+        }
+    }
+
+    static bool boxesOverlap(const Proxy& a, const Proxy& b) {
+        for (int i = 0; i < 5; ++i) {
+            if (a.max[i] < b.min[i] || b.max[i] < a.min[i]) return false;
+        }
+        return true;
+    }
+
+    bool hasPair(int a, int b) const {
+        // Search the shorter list
+        const std::vector<int>& list = (proxies[a].overlaps.size() <= proxies[b].overlaps.size())
+                                     ? proxies[a].overlaps : proxies[b].overlaps;
+        int other = (&list == &proxies[a].overlaps) ? b : a;
+        return std::find(list.begin(), list.end(), other) != list.end();
+    }
+
+    void addPair(int a, int b) {
+        if (hasPair(a, b)) return;
+        proxies[a].overlaps.push_back(b);
+        proxies[b].overlaps.push_back(a);
+        ++pairCount;
+    }
+
+    void removePair(int a, int b) {
+        auto unlink = [](std::vector<int>& list, int id) {
+            auto it = std::find(list.begin(), list.end(), id);
+            if (it == list.end()) return false;
+            *it = list.back();
+            list.pop_back();
+            return true;
+        };
+        if (unlink(proxies[a].overlaps, b)) {
+            unlink(proxies[b].overlaps, a);
+            --pairCount;
+        }
+    }
+
+    void swapEndpoints(int axis, uint32_t i, uint32_t j) {
+        std::swap(endpoints[axis][i], endpoints[axis][j]);
+        setIndex(axis, i);
+        setIndex(axis, j);
+        ++lastSwaps;
+    }
+
+    /**
+     * Move an endpoint towards the start of the axis until it's in order.
+     */
+    void sortDown(int axis, uint32_t i) {
+        std::vector<Endpoint>& list = endpoints[axis];
+        while (i > 0 && endpointLess(list[i], list[i - 1])) {
+            const Endpoint& moving = list[i];
+            const Endpoint& passed = list[i - 1];
+            int a = proxyId(moving);
+            int b = proxyId(passed);
+            if (a != b) {
+                if (!isMax(moving) && isMax(passed)) {
+                    if (boxesOverlap(proxies[a], proxies[b])) addPair(a, b);
+                } else if (isMax(moving) && !isMax(passed)) {
+                    removePair(a, b);
+                }
+            }
+            swapEndpoints(axis, i - 1, i);
+            --i;
+        }
+    }
+
+    /**
+     * Move an endpoint towards the end of the axis until it's in order.
+     */
+    void sortUp(int axis, uint32_t i) {
+        std::vector<Endpoint>& list = endpoints[axis];
+        while (i + 1 < list.size() && endpointLess(list[i + 1], list[i])) {
+            const Endpoint& moving = list[i];
+            const Endpoint& passed = list[i + 1];
+            int a = proxyId(moving);
+            int b = proxyId(passed);
+            if (a != b) {
+                if (isMax(moving) && !isMax(passed)) {
+                    if (boxesOverlap(proxies[a], proxies[b])) addPair(a, b);
+                } else if (!isMax(moving) && isMax(passed)) {
+                    removePair(a, b);
+                }
+            }
+            swapEndpoints(axis, i, i + 1);
+            ++i;
+        }
+    }
+};
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "Handle5D.hpp"
+#include <functional>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+/**
+ * TimerWheel5D - Hierarchical timing wheel for delayed events (despawns,
+ * timed removals)
+ *
+ * Time advances in fixed ticks. Three wheels of 64 slots each cover
+ * 64 ticks, 64^2 ticks and 64^3 ticks ahead; a timer goes in the slot of
+ * the finest wheel its deadline fits. Every 64 ticks one slot of the next
+ * wheel up is emptied back down (cascaded). A tick only touches the timers
+ * in the slots it reaches, so firing k timers costs O(k) however many are
+ * pending. Delays past the last wheel are clamped to its range.
+ *
+ * Cancelled timers stay in their slot and are dropped when it's reached.
+ * Callbacks may schedule and cancel timers.
+ */
+class TimerWheel5D {
+public:
+    using Callback = std::function<void()>;
+
+    static constexpr int SlotBits = 6;
+    static constexpr int SlotsPerWheel = 1 << SlotBits;
+    static constexpr int WheelCount = 3;
+    static constexpr uint64_t MaxTicks = (uint64_t(1) << (SlotBits * WheelCount)) - 1;
+    static constexpr int SlotReserve = 8;
+
+    float tickLength;               // Seconds per tick
+
+    // Timers fired by the last advance (for the debug UI)
+    int lastFired;
+
+    explicit TimerWheel5D(float tick = 1.0f / 64.0f)
+        : tickLength(tick)
+        , lastFired(0)
+        , now(0)
+        , elapsed(0.0f)
+        , pending(0)
+    {
+        // Slots swap buffers with due as they fire, so reserving here keeps
+        // steady-state scheduling off the heap
+        for (int wheel = 0; wheel < WheelCount; ++wheel) {
+            for (int slot = 0; slot < SlotsPerWheel; ++slot) {
+                slots[wheel][slot].reserve(SlotReserve);
+            }
+        }
+        due.reserve(SlotReserve);
+    }
+
+    /**
+     * Drop every pending timer. Timer records are kept and their
+     * generations bumped, so handles from before the clear can't cancel
+     * timers scheduled after it.
+     */
+    void clear() {
+        for (int wheel = 0; wheel < WheelCount; ++wheel) {
+            for (int slot = 0; slot < SlotsPerWheel; ++slot) {
+                slots[wheel][slot].clear();
+            }
+        }
+        freeTimers.clear();
+        for (uint32_t index = 0; index < timers.size(); ++index) {
+            Timer& timer = timers[index];
+            if (timer.active) {
+                timer.active = false;
+                timer.callback = nullptr;
+                ++timer.generation;
+            }
+            freeTimers.push_back(index);
+        }
+        now = 0;
+        elapsed = 0.0f;
+        pending = 0;
+        lastFired = 0;
+    }
+
+    /**
+     * Run a callback once delay seconds have passed (at least one tick
+     * from now).
+     */
+    Handle5D schedule(float delay, Callback callback) {
+        uint64_t ticks = static_cast<uint64_t>(std::ceil(std::max(delay, 0.0f) / tickLength));
+        ticks = std::clamp<uint64_t>(ticks, 1, MaxTicks);
+
+        uint32_t index;
+        if (!freeTimers.empty()) {
+            index = freeTimers.back();
+            freeTimers.pop_back();
+        } else {
+            index = static_cast<uint32_t>(timers.size());
+            timers.emplace_back();
+        }
+        Timer& timer = timers[index];
+        timer.deadline = now + ticks;
+        timer.callback = std::move(callback);
+        timer.active = true;
+        ++pending;
+
+        insert(index);
+        return Handle5D(index, timer.generation);
+    }
+
+    /**
+     * Stop a timer from firing. Handles to fired or cancelled timers are
+     * ignored.
+     */
+    void cancel(Handle5D handle) {
+        if (handle.index >= timers.size()) return;
+        Timer& timer = timers[handle.index];
+        if (!timer.active || timer.generation != handle.generation) return;
+        timer.active = false;
+        timer.callback = nullptr;
+        ++timer.generation;
+        --pending;
+    }
+
+    /**
+     * Advance by deltaTime, firing every timer that comes due.
+     */
+    void advance(float deltaTime) {
+        lastFired = 0;
+        elapsed += deltaTime;
+        while (elapsed >= tickLength) {
+            elapsed -= tickLength;
+            tick();
+        }
+    }
+
+    int getPendingCount() const {
+        return pending;
+    }
+
+private:
+    struct Timer {
+        uint64_t deadline;
+        Callback callback;
+        uint32_t generation;
+        bool active;
+
+        Timer() : deadline(0), generation(0), active(false) {}
+    };
+
+    std::vector<Timer> timers;
+    std::vector<uint32_t> freeTimers;
+    std::vector<uint32_t> slots[WheelCount][SlotsPerWheel];
+    std::vector<uint32_t> due;      // Slot being fired (swapped out so callbacks can schedule)
+    uint64_t now;
+    float elapsed;
+    int pending;
+
+    void insert(uint32_t index) {
+        uint64_t deadline = timers[index].deadline;
+        uint64_t delta = deadline - now;
+        int wheel = 0;
+        while (wheel < WheelCount - 1 && delta >= (uint64_t(1) << (SlotBits * (wheel + 1)))) {
+            ++wheel;
+        }
+        int slot = static_cast<int>((deadline >> (SlotBits * wheel)) & (SlotsPerWheel - 1));
+        slots[wheel][slot].push_back(index);
+    }
+
+    void release(uint32_t index) {
+        freeTimers.push_back(index);
+    }
+
+    /**
+     * Move one slot of a coarser wheel down to where its timers now fit.
+     */
+    void cascade(int wheel) {
+        int slot = static_cast<int>((now >> (SlotBits * wheel)) & (SlotsPerWheel - 1));
+        due.clear();
+        due.swap(slots[wheel][slot]);
+        for (uint32_t index : due) {
+            if (timers[index].active) {
+                insert(index);
+            } else {
+                release(index);
+            }
+        }
+    }
+
+    void tick() {
+        ++now;
+
+        // Coarsest first, so a timer can fall through two wheels in one tick
+        for (int wheel = WheelCount - 1; wheel > 0; --wheel) {
+            if ((now & ((uint64_t(1) << (SlotBits * wheel)) - 1)) == 0) {
+                cascade(wheel);
+            }
+        }
+
+        due.clear();
+        due.swap(slots[0][now & (SlotsPerWheel - 1)]);
+        for (size_t i = 0; i < due.size(); ++i) {
+            uint32_t index = due[i];
+            Timer& timer = timers[index];
+            if (timer.active) {
+                Callback callback = std::move(timer.callback);
+                timer.callback = nullptr;
+                timer.active = false;
+                ++timer.generation;
+                --pending;
+                ++lastFired;
+                release(index);
+                callback();
+            } else {
+                release(index);
+            }
+        }
+    }
+};
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "GameObject5D.hpp"
+#include <unordered_map>
+#include <functional>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * TriggerSystem5D - Volumes that report a visitor entering, staying in and
+ * leaving them (goals, portals, checkpoints, damage zones)
+ *
+ * Triggers don't move, so each is entered once into every cell of a
+ * uniform 5D grid its box covers. The visitor's box is mapped to a cell
+ * range each frame; only when that range changes are the cells looked up
+ * again to collect the nearby triggers. The common frame (visitor still
+ * in the same cells) just tests its box against the few cached
+ * candidates, which is O(1) regardless of how many triggers the level has.
+ *
+ * Triggers too big to insert cell by cell (kill floors) go in a separate
+ * list that is always a candidate.
+ *
+ * Callbacks may move the visitor (teleports, respawns) but must not add
+ * or remove triggers.
+ */
+class TriggerSystem5D {
+public:
+    using Callback = std::function<void(GameObject5D& volume, GameObject5D& visitor)>;
+
+    struct Trigger {
+        GameObject5D* volume;
+        Vec5D boundsMin;            // Volume box grown by the margin
+        Vec5D boundsMax;
+        Callback onEnter;
+        Callback onStay;
+        Callback onExit;
+        bool inside;
+        bool alive;
+    };
+
+    static constexpr int MaxCellsPerTrigger = 1024;
+
+    float cellSize;
+
+    // Work done by the last update (for the debug UI)
+    int lastTests;
+    int lastRegathers;              // Times the candidate list was rebuilt since clear()
+
+    TriggerSystem5D()
+        : cellSize(4.0f)
+        , lastTests(0)
+        , lastRegathers(0)
+        , stamp(0)
+        , candidatesValid(false)
+    {}
+
+    void clear() {
+        triggers.clear();
+        cells.clear();
+        largeTriggers.clear();
+        candidates.clear();
+        insideTriggers.clear();
+        wasInside.clear();
+        visitStamp.clear();
+        candidatesValid = false;
+        lastTests = 0;
+        lastRegathers = 0;
+    }
+
+    /**
+     * Forget the visitor's history: every trigger counts as not entered,
+     * without firing exit events. Used when the visitor is put back to a
+     * saved state.
+     */
+    void resetVisitor() {
+        for (Trigger& trigger : triggers) {
+            trigger.inside = false;
+        }
+        insideTriggers.clear();
+        wasInside.clear();
+        candidatesValid = false;
+    }
+
+    /**
+     * Register a volume. margin grows its box on every side, e.g. so a
+     * solid pad also triggers on the visitor resting against it.
+     */
+    int add(GameObject5D* volume, float margin, Callback onEnter, Callback onStay = nullptr,
+            Callback onExit = nullptr) {
+        Trigger trigger;
+        trigger.volume = volume;
+        volume->getBounds(trigger.boundsMin, trigger.boundsMax);
+        Vec5D pad(margin, margin, margin, margin, margin);
+        trigger.boundsMin -= pad;
+        trigger.boundsMax += pad;
+        trigger.onEnter = std::move(onEnter);
+        trigger.onStay = std::move(onStay);
+        trigger.onExit = std::move(onExit);
+        trigger.inside = false;
+        trigger.alive = true;
+
+        int id = static_cast<int>(triggers.size());
+        triggers.push_back(std::move(trigger));
+        visitStamp.push_back(0);
+
+        Cell lo = cellOf(triggers[id].boundsMin);
+        Cell hi = cellOf(triggers[id].boundsMax);
+        if (cellCount(lo, hi) > MaxCellsPerTrigger) {
+            largeTriggers.push_back(id);
+        } else {
+            forEachCell(lo, hi, [&](uint64_t key) {
+                cells[key].push_back(id);
+            });
+        }
+        candidatesValid = false;
+        return id;
+    }
+
+    /**
+     * Stop reporting a volume. Its slot stays but is never tested again.
+     */
+    void remove(const GameObject5D* volume) {
+        for (Trigger& trigger : triggers) {
+            if (trigger.volume == volume) {
+                trigger.alive = false;
+                trigger.inside = false;
+            }
+        }
+    }
+
+    /**
+     * Test the visitor against nearby triggers and fire events.
+     */
+    void update(GameObject5D& visitor) {
+        Vec5D visitorMin, visitorMax;
+        visitor.getBounds(visitorMin, visitorMax);
+
+        Cell lo = cellOf(visitorMin);
+        Cell hi = cellOf(visitorMax);
+        if (!candidatesValid || !sameCell(lo, visitorLo) || !sameCell(hi, visitorHi)) {
+            gatherCandidates(lo, hi);
+        }
+
+        lastTests = 0;
+        ++stamp;
+        wasInside.swap(insideTriggers);
+        insideTriggers.clear();
+
+        for (int id : candidates) {
+            visitStamp[id] = stamp;
+            Trigger& trigger = triggers[id];
+            if (!trigger.alive) continue;
+            ++lastTests;
+
+            bool overlapping = boxesOverlap(trigger, visitorMin, visitorMax);
+            if (overlapping) {
+                insideTriggers.push_back(id);
+                if (!trigger.inside) {
+                    trigger.inside = true;
+                    if (trigger.onEnter) trigger.onEnter(*trigger.volume, visitor);
+                } else if (trigger.onStay) {
+                    trigger.onStay(*trigger.volume, visitor);
+                }
+            } else if (trigger.inside) {
+                trigger.inside = false;
+                if (trigger.onExit) trigger.onExit(*trigger.volume, visitor);
+            }
+        }
+
+        // Triggers the visitor was in whose cells it has left
+        for (int id : wasInside) {
+            Trigger& trigger = triggers[id];
+            if (visitStamp[id] == stamp || !trigger.inside) continue;
+            trigger.inside = false;
+            if (trigger.onExit) trigger.onExit(*trigger.volume, visitor);
+        }
+    }
+
+    int getTriggerCount() const {
+        return static_cast<int>(triggers.size());
+    }
+
+    int getCandidateCount() const {
+        return static_cast<int>(candidates.size());
+    }
+
+private:
+    struct Cell {
+        int c[5];
+    };
+
+    std::vector<Trigger> triggers;
+    std::unordered_map<uint64_t, std::vector<int>> cells;
+    std::vector<int> largeTriggers;
+
+    // Triggers near the visitor's current cell range
+    std::vector<int> candidates;
+    std::vector<int> insideTriggers;
+    std::vector<int> wasInside;
+    std::vector<uint32_t> visitStamp;
+    uint32_t stamp;
+    Cell visitorLo;
+    Cell visitorHi;
+    bool candidatesValid;
+
+    void gatherCandidates(const Cell& lo, const Cell& hi) {
+        visitorLo = lo;
+        visitorHi = hi;
+        candidatesValid = true;
+        ++lastRegathers;
+
+        ++stamp;
+        candidates.clear();
+        for (int id : largeTriggers) {
+            visitStamp[id] = stamp;
+            candidates.push_back(id);
+        }
+        forEachCell(lo, hi, [&](uint64_t key) {
+            auto it = cells.find(key);
+            if (it == cells.end()) return;
+            for (int id : it->second) {
+                if (visitStamp[id] == stamp) continue;
+                visitStamp[id] = stamp;
+                candidates.push_back(id);
+            }
+        });
+    }
+
+    Cell cellOf(const Vec5D& point) const {
+        Cell cell;
+        for (int i = 0; i < 5; ++i) {
+            float c = std::floor(point[i] / cellSize);
+            cell.c[i] = static_cast<int>(std::clamp(c, -2048.0f, 2047.0f));
+        }
+        return cell;
+    }
+
+    static bool sameCell(const Cell& a, const Cell& b) {
+        for (int i = 0; i < 5; ++i) {
+            if (a.c[i] != b.c[i]) return false;
+        }
+        return true;
+    }
+
+    static long long cellCount(const Cell& lo, const Cell& hi) {
+        long long count = 1;
+        for (int i = 0; i < 5; ++i) {
+            count *= hi.c[i] - lo.c[i] + 1;
+            if (count > MaxCellsPerTrigger) break;
+        }
+        return count;
+    }
+
+    /**
+     * Five 12-bit cell coordinates packed into one key.
+     */
+    static uint64_t packKey(const int c[5]) {
+        uint64_t key = 0;
+        for (int i = 0; i < 5; ++i) {
+            key |= static_cast<uint64_t>(c[i] + 2048) << (12 * i);
+        }
+        return key;
+    }
+
+    template<typename Fn>
+    static void forEachCell(const Cell& lo, const Cell& hi, Fn&& fn) {
+        int c[5];
+        for (int i = 0; i < 5; ++i) c[i] = lo.c[i];
+        while (true) {
+            fn(packKey(c));
+            int axis = 0;
+            while (axis < 5 && ++c[axis] > hi.c[axis]) {
+                c[axis] = lo.c[axis];
+                ++axis;
+            }
+            if (axis == 5) return;
+        }
+    }
+
+    static bool boxesOverlap(const Trigger& trigger, const Vec5D& boxMin, const Vec5D& boxMax) {
+        for (int i = 0; i < 5; ++i) {
+            if (boxMax[i] < trigger.boundsMin[i] || boxMin[i] > trigger.boundsMax[i]) return false;
+        }
+        return true;
+    }
+};
@@ -29,19 +29,19 @@ public:
         objects.clear();
         
         // Ground plane
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(50, 1, 50, 50, 50)
         );
-        ground->color = glm::vec3(0.3f, 0.3f, 0.4f);
+        ground->color() = glm::vec3(0.3f, 0.3f, 0.4f);
         addObject(ground);
         
         // Start platform
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
-        start->color = glm::vec3(0.7f, 0.7f, 0.8f);
+        start->color() = glm::vec3(0.7f, 0.7f, 0.8f);
         addObject(start);
         
         // Create hypercube maze structure
@@ -70,15 +70,15 @@ public:
         addPlatform(Vec5D(32, 3, 0, 2, 2), Vec5D(2, 0.5f, 2, 2, 2), glm::vec3(0.9f, 0.6f, 0.9f));
         
         // Goal platform at hypercube corner
-        auto goalPlatform = std::make_shared<Platform5D>(
+        auto goalPlatform = create<Platform5D>(
             Vec5D(40, 1, 0, 0, 0),
             Vec5D(5, 0.5f, 5, 5, 5)
         );
-        goalPlatform->color = glm::vec3(0.9f, 0.9f, 0.9f);
+        goalPlatform->color() = glm::vec3(0.9f, 0.9f, 0.9f);
         addObject(goalPlatform);
         
         // Goal
-        auto goal = std::make_shared<Goal5D>(Vec5D(40, 3, 0, 0, 0));
+        auto goal = create<Goal5D>(Vec5D(40, 3, 0, 0, 0));
         addObject(goal);
         
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
@@ -86,14 +86,14 @@ public:
 
 private:
     void addMazeSection(const Vec5D& pos, const Vec5D& size, const glm::vec3& color) {
-        auto section = std::make_shared<Platform5D>(pos, size);
-        section->color = color;
+        auto section = create<Platform5D>(pos, size);
+        section->color() = color;
         addObject(section);
     }
     
     void addPlatform(const Vec5D& pos, const Vec5D& size, const glm::vec3& color) {
-        auto platform = std::make_shared<Platform5D>(pos, size);
-        platform->color = color;
+        auto platform = create<Platform5D>(pos, size);
+        platform->color() = color;
         addObject(platform);
     }
 };
@@ -119,49 +119,49 @@ public:
         objects.clear();
         
         // Ground
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(60, 1, 30, 30, 30)
         );
         addObject(ground);
         
         // Start
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
         addObject(start);
         
         // Bridge 1: Visible in XYZ, invisible in XYW
-        auto bridge1 = std::make_shared<Platform5D>(
+        auto bridge1 = create<Platform5D>(
             Vec5D(8, 4, 0, 0, 0),
             Vec5D(8, 0.3f, 4, 0.5f, 4)
         );
-        bridge1->color = glm::vec3(1.0f, 0.5f, 0.5f);
+        bridge1->color() = glm::vec3(1.0f, 0.5f, 0.5f);
         addObject(bridge1);
         
         // Bridge 2: Visible in XYW, invisible in XYZ
-        auto bridge2 = std::make_shared<Platform5D>(
+        auto bridge2 = create<Platform5D>(
             Vec5D(18, 4, 0, 0, 0),
             Vec5D(8, 0.3f, 0.5f, 4, 0.5f)
         );
-        bridge2->color = glm::vec3(0.5f, 1.0f, 0.5f);
+        bridge2->color() = glm::vec3(0.5f, 1.0f, 0.5f);
         addObject(bridge2);
         
         // Bridge 3: Visible in XYV, invisible in others
-        auto bridge3 = std::make_shared<Platform5D>(
+        auto bridge3 = create<Platform5D>(
             Vec5D(28, 4, 0, 0, 0),
             Vec5D(8, 0.3f, 0.5f, 0.5f, 4)
         );
-        bridge3->color = glm::vec3(0.5f, 0.5f, 1.0f);
+        bridge3->color() = glm::vec3(0.5f, 0.5f, 1.0f);
         addObject(bridge3);
         
         // Bridge 4: Exists only in YZW view (perpendicular to X)
-        auto bridge4 = std::make_shared<Platform5D>(
+        auto bridge4 = create<Platform5D>(
             Vec5D(38, 4, 0, 0, 0),
             Vec5D(0.5f, 0.3f, 8, 4, 0.5f)
         );
-        bridge4->color = glm::vec3(1.0f, 1.0f, 0.5f);
+        bridge4->color() = glm::vec3(1.0f, 1.0f, 0.5f);
         addObject(bridge4);
         
         // Safety platforms (visible in multiple views)
@@ -171,13 +171,13 @@ public:
         addPlatform(Vec5D(42, 2, 0, 0, 0), Vec5D(3, 0.5f, 3, 3, 3), glm::vec3(0.7f, 0.7f, 0.7f));
         
         // Goal
-        auto goalPlatform = std::make_shared<Platform5D>(
+        auto goalPlatform = create<Platform5D>(
             Vec5D(50, 1, 0, 0, 0),
             Vec5D(5, 0.5f, 5, 5, 5)
         );
         addObject(goalPlatform);
         
-        auto goal = std::make_shared<Goal5D>(Vec5D(50, 3, 0, 0, 0));
+        auto goal = create<Goal5D>(Vec5D(50, 3, 0, 0, 0));
         addObject(goal);
         
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
@@ -185,8 +185,8 @@ public:
 
 private:
     void addPlatform(const Vec5D& pos, const Vec5D& size, const glm::vec3& color) {
-        auto platform = std::make_shared<Platform5D>(pos, size);
-        platform->color = color;
+        auto platform = create<Platform5D>(pos, size);
+        platform->color() = color;
         addObject(platform);
     }
 };
@@ -211,73 +211,35 @@ public:
         objects.clear();
         
         // Ground
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(80, 1, 80, 80, 80)
         );
         addObject(ground);
         
         // Start
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
         addObject(start);
         
-        // Portal pairs (represented as colored platforms in specific 5D locations)
-        // Portal 1A (red) - entry at (10, 2, 0, 0, 0)
-        auto portal1A = std::make_shared<Platform5D>(
-            Vec5D(10, 2, 0, 0, 0),
-            Vec5D(3, 0.3f, 3, 3, 3)
-        );
-        portal1A->color = glm::vec3(1.0f, 0.2f, 0.2f);
-        portal1A->opacity = 0.7f;
-        addObject(portal1A);
-        
-        // Portal 1B (red) - exit at (15, 2, 0, 15, 0) - far in W dimension
-        auto portal1B = std::make_shared<Platform5D>(
-            Vec5D(15, 2, 0, 15, 0),
-            Vec5D(3, 0.3f, 3, 3, 3)
-        );
-        portal1B->color = glm::vec3(1.0f, 0.2f, 0.2f);
-        portal1B->opacity = 0.7f;
-        addObject(portal1B);
-        
-        // Portal 2A (blue) - entry
-        auto portal2A = std::make_shared<Platform5D>(
-            Vec5D(20, 2, 0, 15, 0),
-            Vec5D(3, 0.3f, 3, 3, 3)
-        );
-        portal2A->color = glm::vec3(0.2f, 0.2f, 1.0f);
-        portal2A->opacity = 0.7f;
-        addObject(portal2A);
-        
-        // Portal 2B (blue) - exit at (25, 2, 0, 0, 20) - far in V dimension
-        auto portal2B = std::make_shared<Platform5D>(
-            Vec5D(25, 2, 0, 0, 20),
-            Vec5D(3, 0.3f, 3, 3, 3)
-        );
-        portal2B->color = glm::vec3(0.2f, 0.2f, 1.0f);
-        portal2B->opacity = 0.7f;
-        addObject(portal2B);
-        
-        // Portal 3A (green) - entry
-        auto portal3A = std::make_shared<Platform5D>(
-            Vec5D(30, 2, 0, 0, 20),
-            Vec5D(3, 0.3f, 3, 3, 3)
-        );
-        portal3A->color = glm::vec3(0.2f, 1.0f, 0.2f);
-        portal3A->opacity = 0.7f;
-        addObject(portal3A);
-        
-        // Portal 3B (green) - exit near goal
-        auto portal3B = std::make_shared<Platform5D>(
-            Vec5D(45, 2, 0, 0, 0),
-            Vec5D(3, 0.3f, 3, 3, 3)
-        );
-        portal3B->color = glm::vec3(0.2f, 1.0f, 0.2f);
-        portal3B->opacity = 0.7f;
-        addObject(portal3B);
+        // Portal pairs - stepping on one end carries you to the other
+        portals.clear();
+        portalLock = nullptr;
+        Vec5D portalSize(3, 0.3f, 3, 3, 3);
+        
+        // Portal 1 (red): (10, 2, 0, 0, 0) <-> (15, 2, 0, 15, 0) - far in W dimension
+        addPortalPair(Vec5D(10, 2, 0, 0, 0), Vec5D(15, 2, 0, 15, 0), portalSize,
+                      glm::vec3(1.0f, 0.2f, 0.2f));
+        
+        // Portal 2 (blue): (20, 2, 0, 15, 0) <-> (25, 2, 0, 0, 20) - far in V dimension
+        addPortalPair(Vec5D(20, 2, 0, 15, 0), Vec5D(25, 2, 0, 0, 20), portalSize,
+                      glm::vec3(0.2f, 0.2f, 1.0f));
+        
+        // Portal 3 (green): (30, 2, 0, 0, 20) <-> (45, 2, 0, 0, 0) - exit near goal
+        addPortalPair(Vec5D(30, 2, 0, 0, 20), Vec5D(45, 2, 0, 0, 0), portalSize,
+                      glm::vec3(0.2f, 1.0f, 0.2f));
         
         // Connecting platforms
         addPlatform(Vec5D(12, 2, 0, 7, 0), Vec5D(2, 0.5f, 2, 2, 2), glm::vec3(0.8f, 0.5f, 0.5f));
@@ -286,13 +248,13 @@ public:
         addPlatform(Vec5D(27, 2, 0, 0, 15), Vec5D(2, 0.5f, 2, 2, 2), glm::vec3(0.8f, 0.8f, 0.5f));
         
         // Goal
-        auto goalPlatform = std::make_shared<Platform5D>(
+        auto goalPlatform = create<Platform5D>(
             Vec5D(50, 1, 0, 0, 0),
             Vec5D(5, 0.5f, 5, 5, 5)
         );
         addObject(goalPlatform);
         
-        auto goal = std::make_shared<Goal5D>(Vec5D(50, 3, 0, 0, 0));
+        auto goal = create<Goal5D>(Vec5D(50, 3, 0, 0, 0));
         addObject(goal);
         
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
@@ -300,8 +262,8 @@ public:
 
 private:
     void addPlatform(const Vec5D& pos, const Vec5D& size, const glm::vec3& color) {
-        auto platform = std::make_shared<Platform5D>(pos, size);
-        platform->color = color;
+        auto platform = create<Platform5D>(pos, size);
+        platform->color() = color;
         addObject(platform);
     }
 };
@@ -327,14 +289,14 @@ public:
         objects.clear();
         
         // Ground
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(70, 1, 40, 40, 40)
         );
         addObject(ground);
         
         // Start
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
@@ -344,43 +306,43 @@ public:
         // Only solid when that dimension is visible
         
         // XY-phase platform (thin in Z, W, V)
-        auto phaseXY = std::make_shared<Platform5D>(
+        auto phaseXY = create<Platform5D>(
             Vec5D(10, 2, 0, 0, 0),
             Vec5D(6, 2, 0.5f, 0.5f, 0.5f)
         );
-        phaseXY->color = glm::vec3(1.0f, 0.5f, 0.5f);
+        phaseXY->color() = glm::vec3(1.0f, 0.5f, 0.5f);
         addObject(phaseXY);
         
         // XW-phase platform (thin in Y, Z, V)
-        auto phaseXW = std::make_shared<Platform5D>(
+        auto phaseXW = create<Platform5D>(
             Vec5D(18, 2, 0, 0, 0),
             Vec5D(6, 0.5f, 0.5f, 4, 0.5f)
         );
-        phaseXW->color = glm::vec3(0.5f, 1.0f, 0.5f);
+        phaseXW->color() = glm::vec3(0.5f, 1.0f, 0.5f);
         addObject(phaseXW);
         
         // XV-phase platform (thin in Y, Z, W)
-        auto phaseXV = std::make_shared<Platform5D>(
+        auto phaseXV = create<Platform5D>(
             Vec5D(26, 2, 0, 0, 0),
             Vec5D(6, 0.5f, 0.5f, 0.5f, 4)
         );
-        phaseXV->color = glm::vec3(0.5f, 0.5f, 1.0f);
+        phaseXV->color() = glm::vec3(0.5f, 0.5f, 1.0f);
         addObject(phaseXV);
         
         // YZ-phase platform
-        auto phaseYZ = std::make_shared<Platform5D>(
+        auto phaseYZ = create<Platform5D>(
             Vec5D(34, 2, 0, 0, 0),
             Vec5D(0.5f, 4, 4, 0.5f, 0.5f)
         );
-        phaseYZ->color = glm::vec3(1.0f, 1.0f, 0.5f);
+        phaseYZ->color() = glm::vec3(1.0f, 1.0f, 0.5f);
         addObject(phaseYZ);
         
         // WV-phase platform
-        auto phaseWV = std::make_shared<Platform5D>(
+        auto phaseWV = create<Platform5D>(
             Vec5D(42, 2, 0, 0, 0),
             Vec5D(0.5f, 0.5f, 0.5f, 4, 4)
         );
-        phaseWV->color = glm::vec3(1.0f, 0.5f, 1.0f);
+        phaseWV->color() = glm::vec3(1.0f, 0.5f, 1.0f);
         addObject(phaseWV);
         
         // Transitional platforms
@@ -391,13 +353,13 @@ public:
         addPlatform(Vec5D(46, 3, 0, 0, 0), Vec5D(2, 0.5f, 2, 2, 2), glm::vec3(0.7f, 0.7f, 0.7f));
         
         // Goal
-        auto goalPlatform = std::make_shared<Platform5D>(
+        auto goalPlatform = create<Platform5D>(
             Vec5D(55, 1, 0, 0, 0),
             Vec5D(5, 0.5f, 5, 5, 5)
         );
         addObject(goalPlatform);
         
-        auto goal = std::make_shared<Goal5D>(Vec5D(55, 3, 0, 0, 0));
+        auto goal = create<Goal5D>(Vec5D(55, 3, 0, 0, 0));
         addObject(goal);
         
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
@@ -405,8 +367,8 @@ public:
 
 private:
     void addPlatform(const Vec5D& pos, const Vec5D& size, const glm::vec3& color) {
-        auto platform = std::make_shared<Platform5D>(pos, size);
-        platform->color = color;
+        auto platform = create<Platform5D>(pos, size);
+        platform->color() = color;
         addObject(platform);
     }
 };
@@ -7,6 +7,8 @@
 
 #include "Level.hpp"
 #include "../engine/GameObject5D.hpp"
+#include "../engine/Physics5D.hpp"
+#include "../engine/ObjectPool5D.hpp"
 #include <cmath>
 #include <vector>
 
@@ -21,8 +23,12 @@ public:
     bool isDestroyed;
     float health;
     float maxHealth;
-    float pulseTime;
     
+    static int tag() {
+        static const int type = ObjectType5D::intern("BossCore");
+        return type;
+    }
+
     BossCore(const Vec5D& pos, int d1, int d2, int d3) 
         : vulnerableDim1(d1)
         , vulnerableDim2(d2)
@@ -30,34 +36,22 @@ public:
         , isDestroyed(false)
         , health(100.0f)
         , maxHealth(100.0f)
-        , pulseTime(0.0f)
     {
-        position = pos;
-        size = Vec5D(2, 2, 2, 2, 2);
+        position() = pos;
+        size() = Vec5D(2, 2, 2, 2, 2);
         isStatic = false;
         isSolid = true;
-        name = "BossCore";
+        typeTag = tag();
+        lightIntensity() = 2.0f;
+        lightRadius() = 8.0f;
     }
     
-    void update(float deltaTime) override {
-        if (isDestroyed) {
-            opacity = 0.2f;
-            return;
-        }
-        
-        pulseTime += deltaTime * 3.0f;
-        
-        // Pulsing effect
-        float pulse = 0.7f + 0.3f * std::sin(pulseTime);
-        opacity = pulse;
-        
-        // Color based on health
-        float healthRatio = health / maxHealth;
-        color = glm::vec3(
-            1.0f - healthRatio * 0.5f,
-            healthRatio,
-            healthRatio * 0.5f
-        );
+    void describe(EntityDesc5D& desc) const override {
+        // Pulsing effect (the level drops the row once the core is destroyed)
+        desc.archetype = EntityDesc5D::Pulser;
+        desc.pulseRate = 3.0f;
+        desc.pulseBase = 0.7f;
+        desc.pulseAmplitude = 0.3f;
     }
     
     bool isVulnerableFromView(int d1, int d2, int d3) const {
@@ -71,7 +65,28 @@ public:
         if (health <= 0) {
             health = 0;
             isDestroyed = true;
+            opacity() = 0.2f;
+            lightIntensity() = 0.0f;
         }
+        
+        // Color based on health
+        float healthRatio = health / maxHealth;
+        color() = glm::vec3(
+            1.0f - healthRatio * 0.5f,
+            healthRatio,
+            healthRatio * 0.5f
+        );
+    }
+    
+    int saveCustomState(float* out) const override {
+        out[0] = health;
+        out[1] = isDestroyed ? 1.0f : 0.0f;
+        return 2;
+    }
+    
+    void loadCustomState(const float* in) override {
+        health = in[0];
+        isDestroyed = in[1] != 0.0f;
     }
 };
 
@@ -82,34 +97,34 @@ class BossProjectile : public GameObject5D {
 public:
     Vec5D direction;
     float speed;
-    float lifetime;
-    float maxLifetime;
+    float maxLifetime;        // Age is tracked by the entity store
     
+    static int tag() {
+        static const int type = ObjectType5D::intern("Projectile");
+        return type;
+    }
+
     BossProjectile(const Vec5D& pos, const Vec5D& dir, float spd)
         : direction(dir.normalized())
         , speed(spd)
-        , lifetime(0.0f)
         , maxLifetime(5.0f)
     {
-        position = pos;
-        velocity = direction * speed;
-        size = Vec5D(0.8f, 0.8f, 0.8f, 0.8f, 0.8f);
+        position() = pos;
+        velocity() = direction * speed;
+        size() = Vec5D(0.8f, 0.8f, 0.8f, 0.8f, 0.8f);
         isStatic = false;
         isSolid = true;
-        color = glm::vec3(1.0f, 0.2f, 0.2f);
-        name = "Projectile";
+        isTransient = true;
+        color() = glm::vec3(1.0f, 0.2f, 0.2f);
+        typeTag = tag();
+        lightIntensity() = 1.0f;
+        lightRadius() = 4.0f;
     }
     
-    void update(float deltaTime) override {
-        GameObject5D::update(deltaTime);
-        lifetime += deltaTime;
-        
-        // Fade out as lifetime approaches max
-        opacity = 1.0f - (lifetime / maxLifetime);
-    }
-    
-    bool isExpired() const {
-        return lifetime >= maxLifetime;
+    void describe(EntityDesc5D& desc) const override {
+        // Flies straight, fading out as its lifetime runs down
+        desc.archetype = EntityDesc5D::Projectile;
+        desc.lifetime = maxLifetime;
     }
 };
 
@@ -130,33 +145,52 @@ public:
  */
 class Level11_ThePentarch : public Level {
 private:
-    std::vector<std::shared_ptr<BossCore>> cores;
-    std::vector<std::shared_ptr<BossProjectile>> projectiles;
+    // Projectiles and hyperwalls live in fixed pools; the level's object
+    // list points at them. Spawns past the cap are skipped.
+    static constexpr int MaxProjectiles = 64;
+    ObjectPool5D<BossProjectile> projectiles;
+    static constexpr int MaxHyperwalls = 8;
+    ObjectPool5D<Platform5D> hyperwalls;
+    
+    static constexpr float HyperwallLifetime = 8.0f;    // Seconds before a hyperwall collapses
+    static constexpr float HoverHeight = 0.75f;         // How far The Pentarch bobs up and down
+    static constexpr float HoverRate = 1.5f;            // Radians per second
+    
+    // The Pentarch's body: its cores are placed relative to this scene
+    // node, so moving it moves all five
+    Vec5D pentarchCenter;
+    int pentarchNode;
     
     float bossPhaseTimer;
     int currentPhase;
     float attackCooldown;
     float attackInterval;
     float geometryChangeTimer;
-    
-    // Arena platforms that change during fight
-    std::vector<std::shared_ptr<MovingPlatform5D>> dynamicPlatforms;
 
 public:
-    Level11_ThePentarch() : Level("The Pentarch", 11) {
+    Level11_ThePentarch()
+        : Level("The Pentarch", 11)
+        , projectiles(MaxProjectiles)
+        , hyperwalls(MaxHyperwalls)
+        , pentarchCenter(20, 9, 4, 6, 3)
+        , pentarchNode(SceneGraph5D::Root)
+    {
         description = "Face The Pentarch - master of all five dimensions. Destroy its cores to win!";
         bossPhaseTimer = 0.0f;
         currentPhase = 1;
         attackCooldown = 0.0f;
         attackInterval = 2.0f;
         geometryChangeTimer = 0.0f;
+        
+        contacts.onContactBegin = [this](CollisionPipeline5D::ContactPair& pair) {
+            onProjectileContact(pair);
+        };
     }
 
     void initialize() override {
         objects.clear();
-        cores.clear();
         projectiles.clear();
-        dynamicPlatforms.clear();
+        hyperwalls.clear();
         
         bossPhaseTimer = 0.0f;
         currentPhase = 1;
@@ -164,104 +198,77 @@ public:
         geometryChangeTimer = 0.0f;
         
         // Arena ground
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(80, 1, 80, 80, 80)
         );
-        ground->color = glm::vec3(0.2f, 0.2f, 0.3f);
+        ground->color() = glm::vec3(0.2f, 0.2f, 0.3f);
         addObject(ground);
         
         // Start platform
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(5, 0.5f, 5, 5, 5)
         );
-        start->color = glm::vec3(0.5f, 0.5f, 0.6f);
+        start->color() = glm::vec3(0.5f, 0.5f, 0.6f);
         addObject(start);
         
         // Create The Pentarch's 5 cores
         // Each core is vulnerable from a different dimensional view
+        pentarchNode = scene.addNode(SceneGraph5D::Root, Transform5D::translate(pentarchCenter));
         
         // Core 1: Vulnerable in XYZ view (standard 3D)
-        auto core1 = std::make_shared<BossCore>(Vec5D(20, 8, 0, 0, 0), 0, 1, 2);
-        core1->color = glm::vec3(1.0f, 0.3f, 0.3f);
-        cores.push_back(core1);
-        addObject(core1);
+        addCore(Vec5D(20, 8, 0, 0, 0), 0, 1, 2, glm::vec3(1.0f, 0.3f, 0.3f));
         
         // Core 2: Vulnerable in XYW view (4D perspective)
-        auto core2 = std::make_shared<BossCore>(Vec5D(20, 8, 0, 15, 0), 0, 1, 3);
-        core2->color = glm::vec3(0.3f, 1.0f, 0.3f);
-        cores.push_back(core2);
-        addObject(core2);
+        addCore(Vec5D(20, 8, 0, 15, 0), 0, 1, 3, glm::vec3(0.3f, 1.0f, 0.3f));
         
         // Core 3: Vulnerable in XYV view (5D perspective)
-        auto core3 = std::make_shared<BossCore>(Vec5D(20, 8, 0, 0, 15), 0, 1, 4);
-        core3->color = glm::vec3(0.3f, 0.3f, 1.0f);
-        cores.push_back(core3);
-        addObject(core3);
+        addCore(Vec5D(20, 8, 0, 0, 15), 0, 1, 4, glm::vec3(0.3f, 0.3f, 1.0f));
         
         // Core 4: Vulnerable in XZW view
-        auto core4 = std::make_shared<BossCore>(Vec5D(20, 8, 12, 8, 0), 0, 2, 3);
-        core4->color = glm::vec3(1.0f, 1.0f, 0.3f);
-        cores.push_back(core4);
-        addObject(core4);
+        addCore(Vec5D(20, 8, 12, 8, 0), 0, 2, 3, glm::vec3(1.0f, 1.0f, 0.3f));
         
         // Core 5: Vulnerable in YZW view
-        auto core5 = std::make_shared<BossCore>(Vec5D(20, 12, 8, 8, 0), 1, 2, 3);
-        core5->color = glm::vec3(1.0f, 0.3f, 1.0f);
-        cores.push_back(core5);
-        addObject(core5);
+        addCore(Vec5D(20, 12, 8, 8, 0), 1, 2, 3, glm::vec3(1.0f, 0.3f, 1.0f));
         
         // Create arena platforms
         createArenaPlatforms();
         
         // Goal (appears after all cores destroyed)
-        auto goal = std::make_shared<Goal5D>(Vec5D(40, 3, 0, 0, 0));
-        goal->isVisible = false;  // Hidden until victory
+        auto goal = create<Goal5D>(Vec5D(40, 3, 0, 0, 0));
+        goal->setVisible(false);  // Hidden until victory
         addObject(goal);
         
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
     }
 
     void update(float deltaTime) override {
+        // Destroyed cores stop pulsing
+        for (GameObject5D* obj : objectsOfType(BossCore::tag())) {
+            if (static_cast<BossCore*>(obj)->isDestroyed) entities.remove(obj);
+        }
+        
         Level::update(deltaTime);
         
         bossPhaseTimer += deltaTime;
         attackCooldown -= deltaTime;
         geometryChangeTimer += deltaTime;
         
-        // Update boss cores
-        for (auto& core : cores) {
-            core->update(deltaTime);
-        }
-        
-        // Update projectiles
-        for (auto it = projectiles.begin(); it != projectiles.end();) {
-            (*it)->update(deltaTime);
-            if ((*it)->isExpired()) {
-                // Remove from objects list too
-                auto objIt = std::find(objects.begin(), objects.end(), *it);
-                if (objIt != objects.end()) {
-                    objects.erase(objIt);
-                }
-                it = projectiles.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        // The Pentarch hovers; moving its node carries all five cores
+        float hover = std::sin(bossPhaseTimer * HoverRate) * HoverHeight;
+        scene.setLocal(pentarchNode, Transform5D::translate(pentarchCenter + Vec5D(0, hover, 0, 0, 0)));
         
         // Determine current phase based on remaining cores
         int activeCores = 0;
-        for (const auto& core : cores) {
-            if (!core->isDestroyed) activeCores++;
+        for (GameObject5D* obj : objectsOfType(BossCore::tag())) {
+            if (!static_cast<BossCore*>(obj)->isDestroyed) activeCores++;
         }
         
         if (activeCores == 0) {
             // Victory! Show goal
-            for (auto& obj : objects) {
-                if (obj->name == "Goal") {
-                    obj->isVisible = true;
-                }
+            for (GameObject5D* goal : objectsOfType(Goal5D::tag())) {
+                goal->setVisible(true);
             }
         } else {
             // Boss behavior based on phase
@@ -287,7 +294,90 @@ public:
         }
     }
 
+    int saveScriptState(float* out) const override {
+        out[0] = bossPhaseTimer;
+        out[1] = static_cast<float>(currentPhase);
+        out[2] = attackCooldown;
+        out[3] = attackInterval;
+        out[4] = geometryChangeTimer;
+        return 5;
+    }
+    
+    void loadScriptState(const float* in) override {
+        bossPhaseTimer = in[0];
+        currentPhase = static_cast<int>(in[1]);
+        attackCooldown = in[2];
+        attackInterval = in[3];
+        geometryChangeTimer = in[4];
+    }
+    
+    void discardObject(GameObject5D* obj) override {
+        if (obj->typeTag == BossProjectile::tag()) {
+            despawnProjectile(projectiles.handleOf(static_cast<BossProjectile*>(obj)));
+            return;
+        }
+        removeObject(obj);
+        if (obj->typeTag == Platform5D::tag()) {
+            hyperwalls.destroy(hyperwalls.handleOf(static_cast<Platform5D*>(obj)));
+        }
+    }
+
 private:
+    size_t coreCount() const {
+        return objectsOfType(BossCore::tag()).size();
+    }
+    
+    BossCore* getCore(size_t i) const {
+        return static_cast<BossCore*>(objectsOfType(BossCore::tag())[i]);
+    }
+    
+    /**
+     * Add a core at a world position, as a child of The Pentarch's node.
+     */
+    void addCore(const Vec5D& pos, int d1, int d2, int d3, const glm::vec3& color) {
+        auto core = create<BossCore>(pos, d1, d2, d3);
+        core->color() = color;
+        addObject(core);
+        scene.addNode(pentarchNode, Transform5D::translate(pos - pentarchCenter), core);
+    }
+    
+    /**
+     * Projectiles knock the player back and break on any solid they reach,
+     * except cores (they spawn inside one) and other projectiles.
+     */
+    void onProjectileContact(CollisionPipeline5D::ContactPair& pair) {
+        GameObject5D* shot = pair.a;
+        GameObject5D* other = pair.b;
+        if (shot->typeTag != BossProjectile::tag()) std::swap(shot, other);
+        if (shot->typeTag != BossProjectile::tag()) return;
+        BossProjectile* projectile = static_cast<BossProjectile*>(shot);
+        if (entities.isExpired(projectile) || !other->isSolid) return;
+        if (other->typeTag == BossProjectile::tag() || other->typeTag == BossCore::tag()) return;
+        
+        if (other == player) {
+            const float knockback = 8.0f;
+            player->velocity() += projectile->direction * knockback;
+        }
+        
+        // Objects can't be removed during contact callbacks; despawn on the next tick
+        entities.expire(projectile);
+        Handle5D handle = projectiles.handleOf(projectile);
+        timers.schedule(0.0f, [this, handle]() {
+            despawnProjectile(handle);
+        });
+    }
+    
+    /**
+     * Remove a projectile from the level and return it to the pool. A
+     * stale handle (already despawned) does nothing.
+     */
+    void despawnProjectile(Handle5D handle) {
+        BossProjectile* projectile = projectiles.get(handle);
+        if (!projectile) return;
+        removeObject(projectile);
+        projectiles.destroy(handle);
+    }
+
     void createArenaPlatforms() {
         // Static safe platforms
         addPlatform(Vec5D(10, 2, 0, 0, 0), Vec5D(4, 0.5f, 4, 4, 4), glm::vec3(0.6f, 0.6f, 0.7f));
@@ -296,22 +386,20 @@ private:
         addPlatform(Vec5D(20, 2, -10, 0, 0), Vec5D(4, 0.5f, 4, 4, 4), glm::vec3(0.6f, 0.6f, 0.7f));
         
         // Dynamic moving platforms
-        auto movingPlat1 = std::make_shared<MovingPlatform5D>(
+        auto movingPlat1 = create<MovingPlatform5D>(
             Vec5D(15, 4, 0, 0, 0),
             Vec5D(25, 4, 0, 10, 0),
             0.3f
         );
-        movingPlat1->color = glm::vec3(0.7f, 0.5f, 0.7f);
-        dynamicPlatforms.push_back(movingPlat1);
+        movingPlat1->color() = glm::vec3(0.7f, 0.5f, 0.7f);
         addObject(movingPlat1);
         
-        auto movingPlat2 = std::make_shared<MovingPlatform5D>(
+        auto movingPlat2 = create<MovingPlatform5D>(
             Vec5D(20, 4, 5, 0, 0),
             Vec5D(20, 4, 5, 0, 10),
             0.4f
         );
-        movingPlat2->color = glm::vec3(0.5f, 0.7f, 0.7f);
-        dynamicPlatforms.push_back(movingPlat2);
+        movingPlat2->color() = glm::vec3(0.5f, 0.7f, 0.7f);
         addObject(movingPlat2);
         
         // Platforms in different dimensional layers
@@ -321,21 +409,58 @@ private:
     }
 
     void addPlatform(const Vec5D& pos, const Vec5D& size, const glm::vec3& color) {
-        auto platform = std::make_shared<Platform5D>(pos, size);
-        platform->color = color;
+        auto platform = create<Platform5D>(pos, size);
+        platform->color() = color;
         addObject(platform);
     }
 
     void bossAttack() {
         // Boss fires projectiles from active cores toward player
-        // In a full implementation, would get actual player position
-        Vec5D playerApproxPos(0, 3, 0, 0, 0);  // Approximate player location
+        Vec5D playerPos = player ? player->position() : playerStartPos;
+        Vec5D playerHalf = player ? player->size() * 0.5f : Vec5D(0.25f, 0.25f, 0.25f, 0.25f, 0.25f);
         
-        for (auto& core : cores) {
+        // Line of sight: each core probes the player's center and the
+        // middles of six faces of the player's box, one packet per core
+        const Vec5D probeOffsets[RayBatch5D::Lanes] = {
+            Vec5D(0, 0, 0, 0, 0),
+            Vec5D(0, playerHalf.y, 0, 0, 0),
+            Vec5D(0, -playerHalf.y, 0, 0, 0),
+            Vec5D(playerHalf.x, 0, 0, 0, 0),
+            Vec5D(-playerHalf.x, 0, 0, 0, 0),
+            Vec5D(0, 0, playerHalf.z, 0, 0),
+            Vec5D(0, 0, -playerHalf.z, 0, 0),
+            Vec5D(0, 0, 0, playerHalf.w, playerHalf.v),
+        };
+        
+        rays.clear();
+        for (size_t c = 0; c < coreCount(); ++c) {
+            BossCore* core = getCore(c);
+            for (const Vec5D& offset : probeOffsets) {
+                // Rays stop just short of the target, so only geometry in
+                // between counts
+                rays.add(core->position(), playerPos + offset - core->position(), 0.999f);
+            }
+        }
+        Physics5D::rayCast(rays, staticIndex);
+        
+        // Indexed rather than iterated: firing adds objects, which may
+        // grow the per-type lists
+        for (size_t c = 0; c < coreCount(); ++c) {
+            BossCore* core = getCore(c);
             if (core->isDestroyed) continue;
             
+            // Aim at the first probe point the core can see
+            int visibleProbe = -1;
+            for (int probe = 0; probe < RayBatch5D::Lanes; ++probe) {
+                if (!rays.hit(static_cast<int>(c) * RayBatch5D::Lanes + probe)) {
+                    visibleProbe = probe;
+                    break;
+                }
+            }
+            if (visibleProbe < 0) continue;
+            
             // Fire projectile toward player (with some randomness)
-            Vec5D direction = playerApproxPos - core->position;
+            Vec5D direction = playerPos + probeOffsets[visibleProbe] - core->position();
             
             // Add randomness based on phase (more accurate in later phases)
             float randomness = 5.0f / currentPhase;
@@ -344,14 +469,18 @@ private:
             direction.z += (std::rand() % 100 / 50.0f - 1.0f) * randomness;
             
             float projectileSpeed = 8.0f + currentPhase * 2.0f;
-            auto projectile = std::make_shared<BossProjectile>(
-                core->position,
+            Handle5D handle = projectiles.create(
+                core->position(),
                 direction,
                 projectileSpeed
             );
+            BossProjectile* projectile = projectiles.get(handle);
+            if (!projectile) continue;
             
-            projectiles.push_back(projectile);
             addObject(projectile);
+            timers.schedule(projectile->maxLifetime, [this, handle]() {
+                despawnProjectile(handle);
+            });
         }
         
         // In later phases, create hyperwalls
@@ -372,18 +501,19 @@ private:
         wallPos[fixedDim] = fixedValue;
         wallSize[fixedDim] = 0.5f;  // Thin in one dimension
         
-        auto hyperwall = std::make_shared<Platform5D>(wallPos, wallSize);
-        hyperwall->color = glm::vec3(0.8f, 0.2f, 0.2f);
-        hyperwall->opacity = 0.6f;
+        // Spawned mid-fight, so from the pool rather than the level arena
+        Platform5D* hyperwall = hyperwalls.get(hyperwalls.create(wallPos, wallSize));
+        if (!hyperwall) return;
+        hyperwall->color() = glm::vec3(0.8f, 0.2f, 0.2f);
+        hyperwall->opacity() = 0.6f;
         addObject(hyperwall);
-        
-        // These walls would need to be removed after some time
-        // In full implementation, add a timer system
+        removeObjectAfter(hyperwall, HyperwallLifetime);
     }
 
     void updateArenaGeometry() {
         // Change moving platform speeds/directions based on phase
-        for (auto& plat : dynamicPlatforms) {
+        for (GameObject5D* obj : objectsOfType(MovingPlatform5D::tag())) {
+            MovingPlatform5D* plat = static_cast<MovingPlatform5D*>(obj);
             plat->speed = 0.3f + currentPhase * 0.2f;
             
             // In final phase, platforms become more chaotic
@@ -393,6 +523,7 @@ private:
                     std::swap(plat->startPos, plat->endPos);
                 }
             }
+            entities.refresh(plat);
         }
     }
 };
@@ -8,6 +8,8 @@
 #include "../engine/Player5D.hpp"
 #include "../engine/Physics5D.hpp"
 #include "../engine/Renderer.hpp"
+#include "../engine/FrameArena.hpp"
+#include "../engine/RewindBuffer5D.hpp"
 #include "../core/DimensionState.hpp"
 #include "Level.hpp"
 #include "AdvancedLevels.hpp"
@@ -15,7 +17,10 @@
 #include "BossLevel.hpp"
 #include <memory>
 #include <vector>
+#include <span>
 #include <fstream>
+#include <chrono>
+#include <cmath>
 
 /**
  * SaveData - Persistent game progress
@@ -57,6 +62,7 @@ class Game {
 public:
     Player5D player;
     DimensionState dimState;
+    Physics5D physics;
     Renderer renderer;
     SaveData saveData;
     
@@ -67,6 +73,28 @@ public:
     bool levelComplete;
     float levelCompleteTimer;
     
+    // Fixed-step simulation
+    float simulationRate;         // Steps per second
+    int maxSubsteps;              // Step budget per frame; time beyond it is dropped
+    float accumulator;            // Unsimulated time carried to the next frame
+    float interpolationAlpha;     // How far rendering sits between the last two steps
+    int lastSubsteps;             // Steps taken by the last advance()
+    
+    // Per-frame scratch (render lists); reset at the start of render()
+    FrameArena frameArena;
+    
+    // Current level as it was right after loading, for restarts
+    LevelSnapshot5D startSnapshot;
+    
+    // Rewind: recent steps kept compressed; holding T plays them backwards
+    static constexpr float RewindSeconds = 30.0f;
+    RewindBuffer5D rewind;
+    float rewindRate;             // Step rate the history is sized for
+    bool rewinding;
+    int rewindBack;               // Steps behind the newest recorded one being shown
+    LevelSnapshot5D rewindSnapshot;
+    std::vector<float> rewindValues;
+    
     // Input state
     bool keys[1024];
     glm::vec2 mousePos;
@@ -77,6 +105,15 @@ public:
         , currentLevelIndex(0)
         , levelComplete(false)
         , levelCompleteTimer(0.0f)
+        , simulationRate(120.0f)
+        , maxSubsteps(8)
+        , accumulator(0.0f)
+        , interpolationAlpha(1.0f)
+        , lastSubsteps(0)
+        , rewind(getRewindFrames(simulationRate), getKeyframeInterval(simulationRate))
+        , rewindRate(simulationRate)
+        , rewinding(false)
+        , rewindBack(0)
         , mouseLocked(false)
     {
         for (int i = 0; i < 1024; ++i) keys[i] = false;
@@ -97,8 +134,8 @@ public:
         player.setDimensionState(&dimState);
     }
 
-    bool initialize() {
-        if (!renderer.initialize()) {
+    bool initialize(int screenWidth, int screenHeight) {
+        if (!renderer.initialize(screenWidth, screenHeight)) {
             return false;
         }
 
@@ -116,20 +153,187 @@ public:
             levelIndex = 0;
         }
 
+        auto loadStart = std::chrono::steady_clock::now();
         currentLevelIndex = levelIndex;
         currentLevel = levels[levelIndex].get();
+        currentLevel->broadphase.clear();
+        currentLevel->transients.clear();
+        currentLevel->clearActive();
+        currentLevel->timers.clear();
+        currentLevel->triggers.clear();
+        currentLevel->entities.clear();
+        currentLevel->goalReached = false;
+        currentLevel->contacts.clear();
+        currentLevel->clearObjects();   // Last: the systems above still point at objects
+        currentLevel->player = &player;
         currentLevel->initialize();
         
-        // Reset player
-        player.position = currentLevel->playerStartPos;
-        player.velocity = Vec5D();
-        player.isGrounded = false;
+        currentLevel->respawnPos = currentLevel->playerStartPos;
+        resetPlayer();
+        currentLevel->buildBroadphase(player);
         
         // Reset dimension state
         dimState = DimensionState();
         
         levelComplete = false;
         levelCompleteTimer = 0.0f;
+        
+        // Restarts put this state back instead of loading again
+        currentLevel->captureSnapshot(startSnapshot);
+        rewind.clear();
+        rewindBack = 0;
+        
+        currentLevel->loadTimeMs = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - loadStart).count();
+    }
+
+    /**
+     * Put the player at the level's start, at rest.
+     */
+    void resetPlayer() {
+        player.position() = currentLevel->playerStartPos;
+        player.previousPosition() = player.position();
+        player.updateBounds();
+        player.velocity() = Vec5D();
+        player.isGrounded = false;
+    }
+
+    float getFixedStep() const {
+        return 1.0f / simulationRate;
+    }
+
+    /**
+     * Steps the rewind history keeps at a given step rate, and how many of
+     * them go between keyframes (one a second).
+     */
+    static int getRewindFrames(float rate) {
+        return static_cast<int>(std::ceil(RewindSeconds * rate));
+    }
+
+    static int getKeyframeInterval(float rate) {
+        return static_cast<int>(std::ceil(rate));
+    }
+
+    /**
+     * Run as many fixed simulation steps as fit in the elapsed frame time.
+     * The remainder carries over and sets the render interpolation alpha.
+     * If more than maxSubsteps steps are due, the rest is dropped so a slow
+     * frame can't snowball into ever longer ones.
+     */
+    void advance(float frameTime) {
+        float step = getFixedStep();
+        accumulator += frameTime;
+
+        // The history holds RewindSeconds at the current rate; frames
+        // recorded at another rate can't be replayed
+        if (simulationRate != rewindRate) {
+            rewindRate = simulationRate;
+            rewind.resize(getRewindFrames(rewindRate), getKeyframeInterval(rewindRate));
+            rewindBack = 0;
+        }
+
+        // Letting go of rewind resumes from the frame shown; what came
+        // after it is gone
+        bool wasRewinding = rewinding;
+        rewinding = keys['t'] || keys['T'];
+        if (wasRewinding && !rewinding) {
+            rewind.discardNewest(rewindBack);
+            rewindBack = 0;
+        }
+
+        lastSubsteps = 0;
+        int rewindShown = rewindBack;
+        while (accumulator >= step && lastSubsteps < maxSubsteps) {
+            if (rewinding) {
+                // Step back through the history instead of simulating
+                if (rewindBack + 1 < rewind.getFrameCount()) ++rewindBack;
+            } else {
+                savePreviousState();
+                update(step);
+                recordRewindFrame();
+            }
+            accumulator -= step;
+            ++lastSubsteps;
+        }
+        if (accumulator >= step) {
+            accumulator = 0.0f;
+        }
+        if (rewinding && rewindBack != rewindShown) {
+            applyRewindFrame();
+        }
+
+        interpolationAlpha = accumulator / step;
+    }
+
+    /**
+     * Add the state after this step to the rewind history. Only the
+     * objects the level loaded with are kept; anything spawned since is
+     * dropped when rewinding. If one of those objects has left the level,
+     * the history can't be replayed onto it and recording stops.
+     */
+    void recordRewindFrame() {
+        if (!currentLevel || !startSnapshot.valid) return;
+        
+        currentLevel->captureSnapshot(rewindSnapshot);
+        size_t objectCount = startSnapshot.objects.size();
+        if (rewindSnapshot.objects.size() < objectCount) {
+            rewind.clear();
+            return;
+        }
+        for (size_t i = 0; i < objectCount; ++i) {
+            if (rewindSnapshot.objects[i].object != startSnapshot.objects[i].object) {
+                rewind.clear();
+                return;
+            }
+        }
+        
+        rewindValues.clear();
+        rewindSnapshot.writeValues(objectCount, rewindValues);
+        for (int d = 0; d < 5; ++d) rewindValues.push_back(player.position()[d]);
+        for (int d = 0; d < 5; ++d) rewindValues.push_back(player.velocity()[d]);
+        size_t playerState = rewindValues.size();
+        rewindValues.resize(playerState + GameObject5D::MaxCustomState);
+        rewindValues.resize(playerState + player.saveCustomState(rewindValues.data() + playerState));
+        rewind.record(rewindValues);
+    }
+    
+    /**
+     * Put the level and player back to the recorded frame rewindBack steps
+     * ago. The view isn't part of the history and stays as it is.
+     */
+    void applyRewindFrame() {
+        if (!currentLevel || !rewind.read(rewindBack, rewindValues)) return;
+        
+        // The layout (which objects, custom state offsets) is the start's
+        rewindSnapshot = startSnapshot;
+        rewindSnapshot.valid = true;
+        const float* in = rewindValues.data() + rewindSnapshot.readValues(rewindValues);
+        for (int d = 0; d < 5; ++d) player.position()[d] = *in++;
+        for (int d = 0; d < 5; ++d) player.velocity()[d] = *in++;
+        player.loadCustomState(in);
+        player.previousPosition() = player.position();
+        player.updateBounds();
+        
+        if (!currentLevel->restoreSnapshot(rewindSnapshot, player)) {
+            rewind.clear();
+            rewindBack = 0;
+            return;
+        }
+        levelComplete = false;
+        levelCompleteTimer = 0.0f;
+    }
+    
+    float getRewindSeconds() const {
+        return static_cast<float>(rewind.getFrameCount()) / simulationRate;
+    }
+
+    /**
+     * Remember where everything was before the next step.
+     */
+    void savePreviousState() {
+        player.previousPosition() = player.position();
+        if (!currentLevel) return;
+        currentLevel->savePreviousPositions();
     }
 
     void update(float deltaTime) {
@@ -145,9 +349,13 @@ public:
         // Update level objects
         if (currentLevel) {
             currentLevel->update(deltaTime);
+            currentLevel->updateIndices();
             
             // Update physics
-            Physics5D::updatePlayer(player, currentLevel->objects, deltaTime);
+            physics.updatePlayer(player, currentLevel->staticIndex, currentLevel->broadphase,
+                                 currentLevel->playerProxy, deltaTime, &currentLevel->transientIndex);
+            currentLevel->updateTriggers(player);
+            currentLevel->updateCollisions();
             
             // Check level completion
             if (currentLevel->isComplete(player) && !levelComplete) {
@@ -174,21 +382,63 @@ public:
 
     void render(int screenWidth, int screenHeight) {
         if (!currentLevel) return;
+        frameArena.reset();
+        
+        // Draw everything between its last two simulated positions: the
+        // entity tables column by column, then the objects without a row
+        EntityStore5D& entities = currentLevel->entities;
+        std::span<GameObject5D*> renderList = buildRenderList();
+        std::span<Vec5D> simulatedRows = frameArena.allocate<Vec5D>(entities.getEntityCount());
+        std::span<Vec5D> simulatedPositions = frameArena.allocate<Vec5D>(renderList.size());
+        size_t saved = 0;
+        entities.forEachTable([&](EntityTable5D& table) {
+            for (int row = 0; row < table.rowCount(); ++row) {
+                simulatedRows[saved++] = table.position[row];
+                table.position[row] = table.previousPosition[row] +
+                    (table.position[row] - table.previousPosition[row]) * interpolationAlpha;
+                table.columns.updateBounds(row);
+            }
+        });
+        for (size_t i = 0; i < renderList.size(); ++i) {
+            GameObject5D* obj = renderList[i];
+            simulatedPositions[i] = obj->position();
+            obj->position() = obj->previousPosition() + (obj->position() - obj->previousPosition()) * interpolationAlpha;
+            obj->updateBounds();
+        }
         
-        // Build object list including player
-        std::vector<std::shared_ptr<GameObject5D>> renderList;
+        // Render scene
+        renderer.renderScene(entities, renderList, currentLevel->portals, dimState, screenWidth, screenHeight);
         
-        // Add all level objects
-        for (auto& obj : currentLevel->objects) {
-            renderList.push_back(obj);
+        saved = 0;
+        entities.forEachTable([&](EntityTable5D& table) {
+            for (int row = 0; row < table.rowCount(); ++row) {
+                table.position[row] = simulatedRows[saved++];
+                table.columns.updateBounds(row);
+            }
+        });
+        for (size_t i = 0; i < renderList.size(); ++i) {
+            renderList[i]->position() = simulatedPositions[i];
+            renderList[i]->updateBounds();
         }
+    }
+
+    /**
+     * Level objects without an entity table row, plus the player, in the
+     * frame arena (valid until the next frame starts). Rows are drawn
+     * from the tables.
+     */
+    std::span<GameObject5D*> buildRenderList() {
+        if (!currentLevel) return std::span<GameObject5D*>();
         
-        // Add player (wrapped in shared_ptr for rendering only)
-        auto playerPtr = std::shared_ptr<GameObject5D>(&player, [](GameObject5D*){});
-        renderList.push_back(playerPtr);
+        size_t count = currentLevel->objects.size() - currentLevel->entities.getEntityCount() + 1;
+        std::span<GameObject5D*> renderList = frameArena.allocate<GameObject5D*>(count);
+        size_t next = 0;
+        for (GameObject5D* obj : currentLevel->objects) {
+            if (obj->entityRow < 0) renderList[next++] = obj;
+        }
+        renderList.back() = &player;
         
-        // Render scene
-        renderer.renderScene(renderList, dimState, screenWidth, screenHeight);
+        return renderList;
     }
 
     void nextLevel() {
@@ -208,8 +458,31 @@ public:
         }
     }
 
+    /**
+     * Restore the snapshot taken when the level loaded. Falls back to a
+     * full reload if the level has lost an object it started with.
+     */
     void restartLevel() {
-        loadLevel(currentLevelIndex);
+        if (!currentLevel) {
+            loadLevel(currentLevelIndex);
+            return;
+        }
+        
+        auto restartStart = std::chrono::steady_clock::now();
+        resetPlayer();
+        if (!currentLevel->restoreSnapshot(startSnapshot, player)) {
+            loadLevel(currentLevelIndex);
+            return;
+        }
+        
+        dimState = DimensionState();
+        levelComplete = false;
+        levelCompleteTimer = 0.0f;
+        rewind.clear();
+        rewindBack = 0;
+        
+        currentLevel->loadTimeMs = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - restartStart).count();
     }
 
     void handleInput(float deltaTime) {
@@ -2,8 +2,22 @@
 
 #include "../engine/GameObject5D.hpp"
 #include "../engine/Player5D.hpp"
+#include "../engine/SweepAndPrune5D.hpp"
+#include "../engine/SpatialHash5D.hpp"
+#include "../engine/BVH5D.hpp"
+#include "../engine/RayBatch5D.hpp"
+#include "../engine/CollisionPipeline5D.hpp"
+#include "../engine/ContactSolver5D.hpp"
+#include "../engine/TriggerSystem5D.hpp"
+#include "../engine/EntityStore5D.hpp"
+#include "../engine/TimerWheel5D.hpp"
+#include "../engine/LevelArena.hpp"
+#include "../engine/LevelSnapshot5D.hpp"
+#include "../engine/SceneGraph5D.hpp"
 #include <vector>
+#include <algorithm>
 #include <memory>
+#include <memory_resource>
 #include <string>
 
 /**
@@ -13,17 +27,79 @@ class Level {
 public:
     std::string name;
     std::string description;
-    std::vector<std::shared_ptr<GameObject5D>> objects;
+    LevelArena objectMemory;            // Objects made by initialize(), freed together
+    std::vector<GameObject5D*> arenaObjects;    // Objects living in objectMemory, destroyed with it
+    std::vector<GameObject5D*> objects;         // Objects in play (not owned: the arena or a pool keeps them)
+    std::vector<std::vector<GameObject5D*>> objectsByType;  // Indexed by type tag (not owned)
+    std::vector<Portal5D*> portals;     // Subset of objects (not owned)
+    Portal5D* portalLock;               // Exit portal the player hasn't left yet
     Vec5D playerStartPos;
     int levelNumber;
+    Player5D* player;                   // Set by the game when the level loads
+    int nextObjectId;                   // ID for the next added object (0 is the player's)
+    float loadTimeMs;                   // How long the last load or restart took (set by the game)
+
+    // Static objects live in a BVH built once per level
+    BVH5D staticIndex;
+    bool staticIndexDirty;
+
+    // Broadphase over moving objects plus the player
+    SweepAndPrune5D broadphase;
+    int playerProxy;
+
+    // Component tables for platforms, moving platforms, goals, boss cores
+    // and projectiles; their behaviour runs as systems over the tables
+    EntityStore5D entities;
+
+    // Other objects updated each frame. Static and resting objects sleep
+    // outside it until a contact or a script wakes them.
+    std::vector<GameObject5D*> activeObjects;
+    static constexpr float SleepDelay = 0.5f;   // Rest time before sleeping
+
+    // Delayed events: projectile despawns, timed removals
+    TimerWheel5D timers;
+
+    // Groups of objects placed relative to a parent (boss cores, ...), so
+    // moving the parent moves the group
+    SceneGraph5D scene;
+
+    // Handle table: object per slot and the slot's current generation
+    std::vector<std::pair<GameObject5D*, uint32_t>> handleSlots;
+    std::vector<uint32_t> freeHandles;
+
+    // Transient objects skip the broadphase and go in a per-frame hash
+    std::vector<GameObject5D*> transients;
+    SpatialHash5D transientIndex;
+
+    // Contact pairs between moving bodies and everything else, and the
+    // solver that resolves them
+    CollisionPipeline5D contacts;
+    ContactSolver5D solver;
+
+    // Goals, portals, checkpoints and damage zones
+    TriggerSystem5D triggers;
+    bool goalReached;
+    Vec5D respawnPos;                   // Where damage zones send the player
+
+    // Shared batch for line-of-sight, aim and visibility rays
+    RayBatch5D rays;
 
     Level(const std::string& n, int num) 
         : name(n)
+        , portalLock(nullptr)
         , levelNumber(num)
         , playerStartPos(0, 2, 0, 0, 0)
+        , player(nullptr)
+        , nextObjectId(1)
+        , loadTimeMs(0.0f)
+        , staticIndexDirty(false)
+        , playerProxy(-1)
+        , goalReached(false)
     {}
 
-    virtual ~Level() = default;
+    virtual ~Level() {
+        destroyArenaObjects();
+    }
 
     /**
      * Initialize level objects
@@ -31,34 +107,575 @@ public:
     virtual void initialize() = 0;
 
     /**
-     * Update all objects in the level
+     * Script variables a snapshot has to keep (phase, timers, ...). Writes
+     * at most LevelSnapshot5D::MaxScriptState floats and returns how many.
      */
-    void update(float deltaTime) {
-        for (auto& obj : objects) {
+    virtual int saveScriptState(float* out) const {
+        (void)out;
+        return 0;
+    }
+
+    virtual void loadScriptState(const float* in) {
+        (void)in;
+    }
+
+    /**
+     * Take an object spawned during play back out of the level. Levels
+     * that pool objects override this to return them to the pool.
+     */
+    virtual void discardObject(GameObject5D* obj) {
+        removeObject(obj);
+    }
+
+    /**
+     * Fire due timers, run the entity systems, then update the awake
+     * objects in the level. Ones that have had nothing to do for
+     * SleepDelay seconds go to sleep.
+     */
+    virtual void update(float deltaTime) {
+        timers.advance(deltaTime);
+        entities.update(deltaTime);
+
+        for (size_t i = 0; i < activeObjects.size();) {
+            GameObject5D* obj = activeObjects[i];
             obj->update(deltaTime);
+            obj->updateBounds();
+
+            obj->restTime = obj->canSleep() ? obj->restTime + deltaTime : 0.0f;
+            if (obj->restTime >= SleepDelay) {
+                // Only the active set gets its previous position saved, so
+                // a sleeper must not be left between two positions
+                obj->isAwake = false;
+                obj->velocity() = Vec5D();
+                obj->previousPosition() = obj->position();
+                removeActive(obj);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    /**
+     * Put an object back in the active set.
+     */
+    void wakeObject(GameObject5D* obj) {
+        obj->restTime = 0.0f;
+        if (obj->isAwake) return;
+        obj->isAwake = true;
+        addActive(obj);
+    }
+
+    /**
+     * Start a step: whatever can move during it remembers where it was.
+     * That is the active set, plus whatever the scene graph moved last
+     * step so it stops interpolating. Entity systems and the scene graph
+     * record the previous position of what they move themselves; anything
+     * else is at rest with its previous position equal to its position.
+     */
+    void savePreviousPositions() {
+        for (GameObject5D* obj : activeObjects) {
+            obj->previousPosition() = obj->position();
+        }
+        scene.settle();
+    }
+
+    void addActive(GameObject5D* obj) {
+        obj->activeSlot = static_cast<int>(activeObjects.size());
+        activeObjects.push_back(obj);
+    }
+
+    /**
+     * Take an object out of the active set; the last one takes its place.
+     */
+    void removeActive(GameObject5D* obj) {
+        int slot = obj->activeSlot;
+        activeObjects[slot] = activeObjects.back();
+        activeObjects[slot]->activeSlot = slot;
+        activeObjects.pop_back();
+        obj->activeSlot = -1;
+    }
+
+    void clearActive() {
+        for (GameObject5D* obj : activeObjects) {
+            obj->activeSlot = -1;
         }
+        activeObjects.clear();
+    }
+
+    /**
+     * Discard an object after a delay, unless it has already gone. Pooled
+     * objects go back to their pool (discardObject).
+     */
+    void removeObjectAfter(GameObject5D* obj, float seconds) {
+        Handle5D handle = obj->handle;
+        timers.schedule(seconds, [this, handle]() {
+            if (GameObject5D* target = resolve(handle)) discardObject(target);
+        });
+    }
+
+    /**
+     * Object a handle refers to, or nullptr if it has left the level.
+     */
+    GameObject5D* resolve(Handle5D handle) const {
+        if (handle.index >= handleSlots.size()) return nullptr;
+        const std::pair<GameObject5D*, uint32_t>& slot = handleSlots[handle.index];
+        return slot.second == handle.generation ? slot.first : nullptr;
+    }
+
+    /**
+     * Every object in the level with a given type tag, e.g.
+     * objectsOfType(Goal5D::tag()).
+     */
+    const std::vector<GameObject5D*>& objectsOfType(int tag) const {
+        static const std::vector<GameObject5D*> none;
+        return tag < static_cast<int>(objectsByType.size()) ? objectsByType[tag] : none;
+    }
+
+    /**
+     * Make an object in the level's arena. It lives until the level is torn
+     * down, even after removeObject(), so objects spawned during play come
+     * from a pool instead, or the arena would grow with every spawn.
+     */
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        T* obj = std::pmr::polymorphic_allocator<T>(&objectMemory).template new_object<T>(
+            std::forward<Args>(args)...);
+        arenaObjects.push_back(obj);
+        return obj;
+    }
+
+    /**
+     * Forget every object (initialize() starts from scratch). Lists keep
+     * their capacity and the arena is released in one step.
+     */
+    void clearObjects() {
+        for (auto& obj : objects) {
+            obj->levelSlot = -1;
+            obj->activeSlot = -1;
+            obj->transientSlot = -1;
+            obj->sceneNode = -1;
+            obj->handle = Handle5D();
+        }
+        objects.clear();
+        scene.clear();
+        for (std::vector<GameObject5D*>& sameType : objectsByType) {
+            sameType.clear();
+        }
+        handleSlots.clear();
+        freeHandles.clear();
+        destroyArenaObjects();
+    }
+
+    /**
+     * Destroy the objects create() made and release their memory in one
+     * step.
+     */
+    void destroyArenaObjects() {
+        for (GameObject5D* obj : arenaObjects) {
+            std::destroy_at(obj);
+        }
+        arenaObjects.clear();
+        objectMemory.release();
     }
 
     /**
      * Add an object to the level
      */
-    void addObject(std::shared_ptr<GameObject5D> obj) {
+    void addObject(GameObject5D* obj) {
+        obj->id = nextObjectId++;
+        obj->previousPosition() = obj->position();
+        obj->updateBounds();
+        obj->isAwake = false;
+        obj->levelSlot = static_cast<int>(objects.size());
         objects.push_back(obj);
+
+        if (freeHandles.empty()) {
+            freeHandles.push_back(static_cast<uint32_t>(handleSlots.size()));
+            handleSlots.emplace_back(nullptr, 0);
+        }
+        uint32_t handleIndex = freeHandles.back();
+        freeHandles.pop_back();
+        handleSlots[handleIndex].first = obj;
+        obj->handle = Handle5D(handleIndex, handleSlots[handleIndex].second);
+
+        if (obj->typeTag >= static_cast<int>(objectsByType.size())) {
+            objectsByType.resize(obj->typeTag + 1);
+        }
+        std::vector<GameObject5D*>& sameType = objectsByType[obj->typeTag];
+        obj->typeSlot = static_cast<int>(sameType.size());
+        sameType.push_back(obj);
+
+        if (entities.add(obj)) {
+            // Rows that move are driven by the entity systems, so never asleep
+            obj->isAwake = !obj->isStatic;
+        } else if (!obj->isStatic || !obj->canSleep()) {
+            wakeObject(obj);
+        }
+        if (obj->isTrigger) {
+            registerTrigger(obj);
+        }
+        if (obj->isTransient) {
+            obj->transientSlot = static_cast<int>(transients.size());
+            transients.push_back(obj);
+        } else if (obj->isStatic) {
+            staticIndexDirty = true;
+        } else if (broadphase.isBuilt()) {
+            broadphase.addProxy(obj);
+        }
     }
 
     /**
-     * Check if level is complete (player reached goal)
+     * Remove an object from the level. The last object takes its place in
+     * the object list. The object itself stays alive with its owner.
+     */
+    void removeObject(GameObject5D* obj) {
+        int slot = obj->levelSlot;
+        if (slot < 0 || slot >= static_cast<int>(objects.size()) || objects[slot] != obj) return;
+
+        if (obj->isTransient) {
+            transients[obj->transientSlot] = transients.back();
+            transients[obj->transientSlot]->transientSlot = obj->transientSlot;
+            transients.pop_back();
+            obj->transientSlot = -1;
+        } else if (obj->isStatic) {
+            staticIndexDirty = true;
+        } else {
+            broadphase.removeObject(obj);
+        }
+        entities.remove(obj);
+        scene.unbind(obj);
+        if (obj->activeSlot >= 0) {
+            removeActive(obj);
+        }
+        contacts.removeObject(obj);
+        if (obj->isTrigger) {
+            triggers.remove(obj);
+        }
+
+        std::vector<GameObject5D*>& sameType = objectsByType[obj->typeTag];
+        sameType[obj->typeSlot] = sameType.back();
+        sameType[obj->typeSlot]->typeSlot = obj->typeSlot;
+        sameType.pop_back();
+        obj->typeSlot = -1;
+
+        handleSlots[obj->handle.index] = std::make_pair(nullptr, obj->handle.generation + 1);
+        freeHandles.push_back(obj->handle.index);
+        obj->handle = Handle5D();
+
+        obj->levelSlot = -1;
+        objects[slot] = objects.back();
+        objects.pop_back();
+        if (slot < static_cast<int>(objects.size())) {
+            objects[slot]->levelSlot = slot;
+        }
+    }
+
+    /**
+     * Build the static BVH and the broadphase from scratch once the
+     * level's objects exist.
+     */
+    void buildBroadphase(Player5D& player) {
+        // Placing objects at load isn't motion: don't interpolate it
+        scene.update([](GameObject5D* obj) {
+            obj->previousPosition() = obj->position();
+        });
+        buildStaticIndex();
+        buildMovingIndex(player);
+    }
+
+    /**
+     * Rebuild the broadphase over the moving objects and the player.
+     */
+    void buildMovingIndex(Player5D& player) {
+        broadphase.clear();
+        for (GameObject5D* obj : objects) {
+            if (obj->isTransient || obj->isStatic) continue;
+            broadphase.addProxy(obj, false);
+        }
+        playerProxy = broadphase.addProxy(&player, false);
+        broadphase.rebuild();
+        entities.resetProxies();
+    }
+
+    /**
+     * Record the level's state for restoreSnapshot(). Timer callbacks
+     * can't be recorded, so with any timer pending the snapshot is left
+     * invalid.
+     */
+    void captureSnapshot(LevelSnapshot5D& snapshot) const {
+        snapshot.clear();
+        snapshot.valid = timers.getPendingCount() == 0;
+
+        for (GameObject5D* obj : objects) {
+            ObjectState5D state;
+            state.object = obj;
+            state.handle = obj->handle;
+            state.position = obj->position();
+            state.velocity = obj->velocity();
+            state.size = obj->size();
+            state.previousPosition = obj->previousPosition();
+            state.color = obj->color();
+            state.opacity = obj->opacity();
+            state.lightIntensity = obj->lightIntensity();
+            state.lightRadius = obj->lightRadius();
+            state.restTime = obj->restTime;
+            state.inverseMass = obj->inverseMass;
+            state.flags = (obj->isStatic ? ObjectState5D::Static : 0) |
+                          (obj->isSolid ? ObjectState5D::Solid : 0) |
+                          (obj->isAwake ? ObjectState5D::Awake : 0) |
+                          (obj->isVisible() ? ObjectState5D::Visible : 0);
+            state.hasRow = obj->entityRow >= 0;
+            state.row = EntityStore5D::RowState();
+            if (state.hasRow) entities.saveRow(obj, state.row);
+
+            size_t offset = snapshot.custom.size();
+            snapshot.custom.resize(offset + GameObject5D::MaxCustomState);
+            int count = obj->saveCustomState(snapshot.custom.data() + offset);
+            snapshot.custom.resize(offset + count);
+            state.customOffset = static_cast<uint32_t>(offset);
+            state.customCount = static_cast<uint8_t>(count);
+
+            snapshot.objects.push_back(state);
+        }
+        for (GameObject5D* obj : activeObjects) {
+            snapshot.active.push_back(obj->levelSlot);
+        }
+
+        snapshot.scriptCount = saveScriptState(snapshot.script);
+        snapshot.respawnPos = respawnPos;
+        snapshot.nextObjectId = nextObjectId;
+    }
+
+    /**
+     * Put the level back to a captured state: discard objects spawned
+     * since, copy every captured object's state back and reset the
+     * systems. Returns false, changing nothing, if a captured object has
+     * left the level; it then has to be reloaded. The player must already
+     * be where it should be, since it goes back into the broadphase.
+     */
+    bool restoreSnapshot(const LevelSnapshot5D& snapshot, Player5D& player) {
+        if (!snapshot.valid || objects.size() < snapshot.objects.size()) return false;
+        for (size_t i = 0; i < snapshot.objects.size(); ++i) {
+            const ObjectState5D& state = snapshot.objects[i];
+            if (objects[i] != state.object || resolve(state.handle) != state.object) return false;
+        }
+
+        // Spawned objects sit after the captured ones
+        while (objects.size() > snapshot.objects.size()) {
+            discardObject(objects.back());
+        }
+
+        timers.clear();
+        contacts.clear();
+        triggers.resetVisitor();
+        entities.clear();
+        clearActive();
+
+        for (size_t i = 0; i < snapshot.objects.size(); ++i) {
+            const ObjectState5D& state = snapshot.objects[i];
+            GameObject5D* obj = state.object;
+            obj->position() = state.position;
+            obj->velocity() = state.velocity;
+            obj->size() = state.size;
+            obj->previousPosition() = state.previousPosition;
+            obj->color() = state.color;
+            obj->opacity() = state.opacity;
+            obj->lightIntensity() = state.lightIntensity;
+            obj->lightRadius() = state.lightRadius;
+            obj->restTime = state.restTime;
+            obj->inverseMass = state.inverseMass;
+            obj->isStatic = (state.flags & ObjectState5D::Static) != 0;
+            obj->isSolid = (state.flags & ObjectState5D::Solid) != 0;
+            obj->isAwake = (state.flags & ObjectState5D::Awake) != 0;
+            obj->setVisible((state.flags & ObjectState5D::Visible) != 0);
+            obj->loadCustomState(snapshot.custom.data() + state.customOffset);
+            obj->updateBounds();
+
+            // Rows go back in capture order, so the tables match too
+            if (state.hasRow && entities.add(obj)) {
+                entities.loadRow(obj, state.row);
+            }
+        }
+        for (int slot : snapshot.active) {
+            addActive(objects[slot]);
+        }
+
+        loadScriptState(snapshot.script);
+        respawnPos = snapshot.respawnPos;
+        nextObjectId = snapshot.nextObjectId;
+        goalReached = false;
+        portalLock = nullptr;
+
+        if (staticIndexDirty) {
+            buildStaticIndex();
+        }
+        buildMovingIndex(player);
+        return true;
+    }
+
+    /**
+     * Rebuild the BVH over the level's static objects.
+     */
+    void buildStaticIndex() {
+        std::vector<GameObject5D*> statics;
+        for (GameObject5D* obj : objects) {
+            if (obj->isStatic && !obj->isTransient) {
+                statics.push_back(obj);
+            }
+        }
+        staticIndex.build(statics);
+        staticIndexDirty = false;
+    }
+
+    /**
+     * Bring the collision indices up to date after objects have moved
+     * (or static objects were added or removed).
+     */
+    void updateIndices() {
+        updateScene();
+        if (staticIndexDirty) {
+            buildStaticIndex();
+        }
+        broadphase.update(activeObjects);
+        updateMoverProxies();
+        transientIndex.build(transients);
+    }
+
+    /**
+     * Move the objects of scene nodes that changed this step. Static ones
+     * need the BVH rebuilt; moving ones have their proxy refit.
+     */
+    void updateScene() {
+        scene.update([this](GameObject5D* obj) {
+            if (obj->isStatic) {
+                staticIndexDirty = true;
+                return;
+            }
+            int proxy = broadphase.findProxy(obj);
+            if (proxy >= 0) broadphase.updateProxy(proxy);
+        });
+    }
+
+    /**
+     * Fit the broadphase proxies of the entity store's moving platforms to
+     * the bounds their system wrote, straight from the table's columns.
      */
-    bool isComplete(const Player5D& player) const {
-        for (const auto& obj : objects) {
-            if (obj->name == "Goal") {
-                Goal5D* goal = dynamic_cast<Goal5D*>(obj.get());
-                if (goal && goal->contains(player.position)) {
-                    return true;
-                }
+    void updateMoverProxies() {
+        MoverTable5D& movers = entities.movers;
+        for (int i = 0; i < movers.rowCount(); ++i) {
+            if (movers.proxy[i] < 0) {
+                movers.proxy[i] = broadphase.findProxy(movers.object[i]);
+                if (movers.proxy[i] < 0) continue;
+            }
+            broadphase.updateProxy(movers.proxy[i], movers.boundsMin[i], movers.boundsMax[i]);
+        }
+    }
+
+    /**
+     * Find and solve this frame's contacts once everything, the player
+     * included, has moved. The player's ground and wall flags come from
+     * the solved contacts.
+     */
+    void updateCollisions() {
+        contacts.update(staticIndex, broadphase, transients, transientIndex);
+
+        // Anything awake touching a sleeping moving object wakes it
+        contacts.forEachContact([&](CollisionPipeline5D::ContactPair& pair) {
+            if (pair.a->isAwake != pair.b->isAwake) {
+                GameObject5D* sleeper = pair.a->isAwake ? pair.b : pair.a;
+                if (!sleeper->isStatic && sleeper != player) wakeObject(sleeper);
+            }
+        });
+
+        solver.solve(contacts);
+        if (!player) return;
+
+        contacts.forEachContact([&](CollisionPipeline5D::ContactPair& pair) {
+            if (!pair.involves(player)) return;
+            GameObject5D* other = pair.other(player);
+
+            // Normals pointing at the player, depth already solved
+            for (int i = 0; i < pair.manifoldCount; ++i) {
+                Physics5D::CollisionInfo collision = pair.manifolds[i];
+                collision.object = other;
+                collision.penetration = 0.0f;
+                if (pair.b == player) collision.normal = collision.normal * -1.0f;
+                Physics5D::resolvePlayerCollision(*player, *other, collision);
             }
+        });
+    }
+
+    /**
+     * Create two portals linked to each other and add them to the level
+     */
+    void addPortalPair(const Vec5D& posA, const Vec5D& posB, const Vec5D& size, const glm::vec3& color) {
+        auto portalA = create<Portal5D>(posA, size, color);
+        auto portalB = create<Portal5D>(posB, size, color);
+        portalA->linked = portalB;
+        portalB->linked = portalA;
+        portals.push_back(portalA);
+        portals.push_back(portalB);
+        addObject(portalA);
+        addObject(portalB);
+    }
+
+    /**
+     * Fire trigger events for the player (portals, goals, checkpoints,
+     * damage zones).
+     */
+    void updateTriggers(Player5D& player) {
+        triggers.update(player);
+    }
+
+    /**
+     * Hook a trigger object's events up to its behaviour.
+     */
+    void registerTrigger(GameObject5D* obj) {
+        if (obj->typeTag == Portal5D::tag()) {
+            Portal5D* portal = static_cast<Portal5D*>(obj);
+            // After arriving, the exit portal stays inert until the player
+            // steps off it, otherwise they would bounce straight back
+            triggers.add(portal, Portal5D::TouchMargin,
+                [this, portal](GameObject5D&, GameObject5D& visitor) {
+                    if (portal == portalLock || !portal->linked) return;
+                    // Shift the previous state too so rendering doesn't smear across the jump
+                    visitor.position() += portal->linkOffset();
+                    visitor.previousPosition() += portal->linkOffset();
+                    visitor.updateBounds();
+                    portalLock = portal->linked;
+                },
+                nullptr,
+                [this, portal](GameObject5D&, GameObject5D&) {
+                    if (portal == portalLock) portalLock = nullptr;
+                });
+        } else if (obj->typeTag == Goal5D::tag()) {
+            Goal5D* goal = static_cast<Goal5D*>(obj);
+            // The player's center has to be inside, and hidden goals don't count
+            auto reach = [this, goal](GameObject5D&, GameObject5D& visitor) {
+                if (goal->isVisible() && goal->contains(visitor.position())) goalReached = true;
+            };
+            triggers.add(goal, 0.0f, reach, reach);
+        } else if (obj->typeTag == Checkpoint5D::tag()) {
+            Checkpoint5D* checkpoint = static_cast<Checkpoint5D*>(obj);
+            triggers.add(checkpoint, 0.0f, [this, checkpoint](GameObject5D&, GameObject5D&) {
+                checkpoint->activate();
+                respawnPos = checkpoint->position();
+            });
+        } else if (obj->typeTag == DamageZone5D::tag()) {
+            triggers.add(obj, 0.0f, [this](GameObject5D&, GameObject5D& visitor) {
+                visitor.position() = respawnPos;
+                visitor.previousPosition() = respawnPos;
+                visitor.updateBounds();
+                visitor.velocity() = Vec5D();
+            });
         }
-        return false;
+    }
+
+    /**
+     * Check if level is complete (player reached goal)
+     */
+    bool isComplete(const Player5D&) const {
+        return goalReached;
     }
 };
 
@@ -80,49 +697,49 @@ public:
         objects.clear();
         
         // Ground platform (visible in all dimensions)
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(20, 1, 20, 20, 20)
         );
-        ground->color = glm::vec3(0.5f, 0.5f, 0.6f);
+        ground->color() = glm::vec3(0.5f, 0.5f, 0.6f);
         addObject(ground);
         
         // Starting platform
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
-        start->color = glm::vec3(0.7f, 0.7f, 0.8f);
+        start->color() = glm::vec3(0.7f, 0.7f, 0.8f);
         addObject(start);
         
         // Hidden platform - only visible when viewing XYW or XYV
         // Located at W=5, invisible in standard XYZ view
-        auto hiddenPlatform = std::make_shared<Platform5D>(
+        auto hiddenPlatform = create<Platform5D>(
             Vec5D(8, 1, 0, 5, 0),
             Vec5D(4, 0.5f, 4, 2, 4)
         );
-        hiddenPlatform->color = glm::vec3(1.0f, 0.7f, 0.3f);
+        hiddenPlatform->color() = glm::vec3(1.0f, 0.7f, 0.3f);
         addObject(hiddenPlatform);
         
         // Wall to demonstrate 5D bypass
         // This wall blocks in XYZ but can be bypassed via W dimension
-        auto wall = std::make_shared<Platform5D>(
+        auto wall = create<Platform5D>(
             Vec5D(6, 3, 0, 0, 0),
             Vec5D(1, 6, 6, 1, 6)
         );
-        wall->color = glm::vec3(0.8f, 0.3f, 0.3f);
+        wall->color() = glm::vec3(0.8f, 0.3f, 0.3f);
         addObject(wall);
         
         // Goal platform
-        auto goalPlatform = std::make_shared<Platform5D>(
+        auto goalPlatform = create<Platform5D>(
             Vec5D(15, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
-        goalPlatform->color = glm::vec3(0.7f, 0.7f, 0.8f);
+        goalPlatform->color() = glm::vec3(0.7f, 0.7f, 0.8f);
         addObject(goalPlatform);
         
         // Goal
-        auto goal = std::make_shared<Goal5D>(Vec5D(15, 3, 0, 0, 0));
+        auto goal = create<Goal5D>(Vec5D(15, 3, 0, 0, 0));
         addObject(goal);
         
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
@@ -147,21 +764,21 @@ public:
         objects.clear();
         
         // Ground
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(30, 1, 20, 20, 20)
         );
         addObject(ground);
         
         // Starting platform
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
         addObject(start);
         
         // Moving platform 1: Moves in X-Y plane
-        auto moving1 = std::make_shared<MovingPlatform5D>(
+        auto moving1 = create<MovingPlatform5D>(
             Vec5D(5, 1, 0, 0, 0),
             Vec5D(10, 4, 0, 0, 0),
             0.5f
@@ -170,41 +787,52 @@ public:
         
         // Moving platform 2: Moves in W dimension
         // Appears/disappears in XYZ view as it moves through W
-        auto moving2 = std::make_shared<MovingPlatform5D>(
+        auto moving2 = create<MovingPlatform5D>(
             Vec5D(15, 1, 0, -3, 0),
             Vec5D(15, 1, 0, 3, 0),
             0.3f
         );
-        moving2->color = glm::vec3(0.9f, 0.6f, 0.9f);
+        moving2->color() = glm::vec3(0.9f, 0.6f, 0.9f);
         addObject(moving2);
         
         // Static platform for landing
-        auto mid = std::make_shared<Platform5D>(
+        auto mid = create<Platform5D>(
             Vec5D(20, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
         addObject(mid);
         
+        // Checkpoint on the landing platform
+        addObject(create<Checkpoint5D>(Vec5D(20, 2.5f, 0, 0, 0)));
+        
         // Moving platform 3: Moves in V dimension
-        auto moving3 = std::make_shared<MovingPlatform5D>(
+        auto moving3 = create<MovingPlatform5D>(
             Vec5D(25, 2, 0, 0, -4),
             Vec5D(25, 2, 0, 0, 4),
             0.4f
         );
-        moving3->color = glm::vec3(0.6f, 0.9f, 0.6f);
+        moving3->color() = glm::vec3(0.6f, 0.9f, 0.6f);
         addObject(moving3);
         
         // Goal platform
-        auto goalPlatform = std::make_shared<Platform5D>(
+        auto goalPlatform = create<Platform5D>(
             Vec5D(30, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
         addObject(goalPlatform);
         
         // Goal
-        auto goal = std::make_shared<Goal5D>(Vec5D(30, 3, 0, 0, 0));
+        auto goal = create<Goal5D>(Vec5D(30, 3, 0, 0, 0));
         addObject(goal);
         
+        // Falling off the course sends the player back to the checkpoint
+        auto killFloor = create<DamageZone5D>(
+            Vec5D(15, -20, 0, 0, 0),
+            Vec5D(200, 10, 200, 200, 200)
+        );
+        killFloor->setVisible(false);
+        addObject(killFloor);
+        
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
     }
 };
@@ -227,14 +855,14 @@ public:
         objects.clear();
         
         // Ground
-        auto ground = std::make_shared<Platform5D>(
+        auto ground = create<Platform5D>(
             Vec5D(0, 0, 0, 0, 0),
             Vec5D(40, 1, 40, 40, 40)
         );
         addObject(ground);
         
         // Start platform
-        auto start = std::make_shared<Platform5D>(
+        auto start = create<Platform5D>(
             Vec5D(0, 1, 0, 0, 0),
             Vec5D(4, 0.5f, 4, 4, 4)
         );
@@ -260,15 +888,15 @@ public:
         addPlatform(Vec5D(25, 1, 5, -2, 3), Vec5D(3, 0.5f, 3, 3, 3), glm::vec3(0.9f, 0.5f, 0.9f));
         
         // Goal platform - requires navigating through multiple dimensions
-        auto goalPlatform = std::make_shared<Platform5D>(
+        auto goalPlatform = create<Platform5D>(
             Vec5D(30, 1, 0, 0, 0),
             Vec5D(5, 0.5f, 5, 5, 5)
         );
-        goalPlatform->color = glm::vec3(0.9f, 0.9f, 0.9f);
+        goalPlatform->color() = glm::vec3(0.9f, 0.9f, 0.9f);
         addObject(goalPlatform);
         
         // Goal
-        auto goal = std::make_shared<Goal5D>(Vec5D(30, 3, 0, 0, 0));
+        auto goal = create<Goal5D>(Vec5D(30, 3, 0, 0, 0));
         addObject(goal);
         
         playerStartPos = Vec5D(0, 3, 0, 0, 0);
@@ -276,14 +904,14 @@ public:
 
 private:
     void addMazeWall(const Vec5D& pos, const Vec5D& size) {
-        auto wall = std::make_shared<Platform5D>(pos, size);
-        wall->color = glm::vec3(0.7f, 0.3f, 0.3f);
+        auto wall = create<Platform5D>(pos, size);
+        wall->color() = glm::vec3(0.7f, 0.3f, 0.3f);
         addObject(wall);
     }
 
     void addPlatform(const Vec5D& pos, const Vec5D& size, const glm::vec3& color) {
-        auto platform = std::make_shared<Platform5D>(pos, size);
-        platform->color = color;
+        auto platform = create<Platform5D>(pos, size);
+        platform->color() = color;
         addObject(platform);
     }
 };
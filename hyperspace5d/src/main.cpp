@@ -4,12 +4,372 @@
 #include <imgui_impl_sdl2.h>
 #include <imgui_impl_opengl3.h>
 #include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <string>
+#include <new>
+#include <random>
+#include <cmath>
 #include "game/Game.hpp"
 
 const int SCREEN_WIDTH = 1280;
 const int SCREEN_HEIGHT = 720;
 
+// Global allocation functions, replaced only to count calls (debug UI)
+void* operator new(std::size_t size) {
+    AllocationCounter::total().fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    AllocationCounter::total().fetch_add(1, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+/**
+ * Render a level's start view with the CPU raymarcher and write it as a PPM.
+ * Needs no window or GL context.
+ */
+int renderHeadless(int levelNumber, const char* outputPath, int width, int height) {
+    Game game;
+    game.loadLevel(levelNumber - 1);
+
+    Renderer& renderer = game.renderer;
+    auto start = std::chrono::steady_clock::now();
+    renderer.raymarcher.build(game.currentLevel->entities, game.buildRenderList(), game.dimState);
+
+    std::vector<uint8_t> pixels;
+    renderer.raymarcher.renderCPU(width, height, renderer.viewMatrix(),
+                                  renderer.projectionMatrix((float)width / (float)height),
+                                  renderer.lightPos, pixels);
+    float elapsedMs = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream file(outputPath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open output file: " << outputPath << std::endl;
+        return 1;
+    }
+    file << "P6\n" << width << " " << height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+
+    std::cout << "Rendered " << game.getCurrentLevelName() << " (" << width << "x" << height
+              << ", " << renderer.raymarcher.boxes.size() << " boxes, "
+              << renderer.raymarcher.cellCount() << " cells) in " << elapsedMs << " ms" << std::endl;
+    return 0;
+}
+
+/**
+ * Drive the dynamic resolution controller with a synthetic GPU load: a
+ * spike that forces the scale down, then headroom. The scene pass is
+ * modelled as costing fullScaleMs * scale^2. Fails unless the scale
+ * drops during the spike and climbs all the way back to maxScale.
+ */
+int checkDynamicResolution() {
+    DynamicResolution resolution;
+    auto run = [&](float fullScaleMs, int frames) {
+        for (int i = 0; i < frames; ++i) {
+            resolution.update(fullScaleMs * resolution.scale * resolution.scale);
+        }
+    };
+
+    const float spikeMs = resolution.targetFrameMs * 2.5f;
+    const float idleMs = resolution.targetFrameMs * 0.5f;
+    run(idleMs, 120);
+    float before = resolution.scale;
+    run(spikeMs, 600);
+    float spiked = resolution.scale;
+    run(idleMs, 1200);
+    float recovered = resolution.scale;
+
+    std::cout << "Dynamic resolution: " << before << " -> " << spiked << " (spike) -> "
+              << recovered << " (headroom)" << std::endl;
+    if (before != resolution.maxScale || spiked >= resolution.maxScale ||
+        recovered != resolution.maxScale) {
+        std::cerr << "Scale did not return to " << resolution.maxScale << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Play every level headless with scripted input (walk forward, jump every
+ * 1.5 s) and count heap allocations once the frame has warmed up: scratch
+ * buffers grown and the rewind history full. Runs at the default step rate
+ * and at both ends of the Sim Rate slider, since the history is sized by
+ * it. Fails if any steady-state frame allocated. Covers simulation and the render list; GL submission
+ * needs a window, where the Debug Info window shows the same counter.
+ */
+int checkAllocations() {
+    const float frameTime = 1.0f / 60.0f;
+    // The history holds RewindSeconds of play at any step rate
+    const int warmupFrames = static_cast<int>((Game::RewindSeconds + 5.0f) / frameTime);
+    const int measuredFrames = 60 * 60;
+
+    Game game;
+    int failedRuns = 0;
+    for (float rate : {120.0f, 30.0f, 240.0f}) {
+        game.simulationRate = rate;
+        for (int level = 0; level < static_cast<int>(game.levels.size()); ++level) {
+            game.loadLevel(level);
+            std::string name = game.getCurrentLevelName();
+            game.handleKeyPress('w');
+            game.handleKeyPress('d');
+
+            uint64_t allocations = 0;
+            int allocatingFrames = 0;
+            for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame) {
+                uint64_t allocationsBefore = AllocationCounter::count();
+                if (frame % 90 == 0) {
+                    game.handleKeyPress(' ');
+                    game.handleKeyRelease(' ');
+                }
+                game.advance(frameTime);
+                game.frameArena.reset();
+                game.buildRenderList();
+                uint64_t frameAllocations = AllocationCounter::count() - allocationsBefore;
+
+                if (frame >= warmupFrames && frameAllocations > 0) {
+                    allocations += frameAllocations;
+                    ++allocatingFrames;
+                }
+            }
+            game.handleKeyRelease('w');
+            game.handleKeyRelease('d');
+
+            std::cout << "Level " << (level + 1) << " (" << name << ") at " << rate << " Hz: "
+                      << allocations << " allocations in " << allocatingFrames << " of "
+                      << measuredFrames << " steady-state frames" << std::endl;
+            if (allocations > 0) ++failedRuns;
+        }
+    }
+
+    if (failedRuns > 0) {
+        std::cerr << failedRuns << " level run(s) allocate in the steady state" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Time the sweep-and-prune broadphase against brute force on random 5D
+ * boxes at constant density, a tenth of them moving, plus a player. Brute
+ * force tests every moving box and the player against every box; at 100k
+ * boxes it runs for one frame only. SAP pairs include its 0.2 margin, so
+ * they can outnumber the exact overlaps.
+ */
+int benchmarkBroadphase() {
+    using Clock = std::chrono::steady_clock;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::cout << "objects   SAP/frame (ms)   brute/frame (ms)   build (ms)   pairs   overlaps" << std::endl;
+    for (int count : {1000, 10000, 100000}) {
+        float extent = 20.0f * std::pow(static_cast<float>(count), 0.2f);
+        std::vector<std::unique_ptr<Platform5D>> boxes;
+        SweepAndPrune5D broadphase;
+        for (int i = 0; i < count; ++i) {
+            Vec5D position, size;
+            for (int d = 0; d < 5; ++d) {
+                position[d] = unit(random) * extent;
+                size[d] = 1.0f + unit(random) * 2.0f;
+            }
+            boxes.push_back(std::make_unique<Platform5D>(position, size));
+            boxes.back()->isStatic = i % 10 != 0;
+            boxes.back()->updateBounds();
+            broadphase.addProxy(boxes.back().get(), false);
+        }
+        Player5D player;
+        player.position() = Vec5D(extent, extent, extent, extent, extent) * 0.5f;
+        player.updateBounds();
+        broadphase.addProxy(&player, false);
+
+        auto buildStart = Clock::now();
+        broadphase.rebuild();
+        double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+
+        const int frames = 60;
+        const int bruteFrames = count >= 100000 ? 1 : frames;
+        double sweepMs = 0.0;
+        double bruteMs = 0.0;
+        int pairs = 0;
+        int overlaps = 0;
+        for (int frame = 0; frame < frames; ++frame) {
+            float shift = 0.05f * std::sin(frame * 0.1f);
+            for (auto& box : boxes) {
+                if (box->isStatic) continue;
+                box->position()[0] += shift;
+                box->updateBounds();
+            }
+            player.position()[0] += 0.05f;
+            player.updateBounds();
+
+            auto sweepStart = Clock::now();
+            broadphase.update();
+            pairs = 0;
+            broadphase.forEachPair([&](GameObject5D*, GameObject5D*) { ++pairs; });
+            sweepMs += std::chrono::duration<double, std::milli>(Clock::now() - sweepStart).count();
+
+            if (frame >= bruteFrames) continue;
+            auto bruteStart = Clock::now();
+            overlaps = 0;
+            for (int i = 0; i < count; ++i) {
+                if (boxes[i]->isStatic) continue;
+                for (int j = 0; j < count; ++j) {
+                    if (j == i || (j < i && !boxes[j]->isStatic)) continue;
+                    overlaps += boxes[i]->intersects(*boxes[j]);
+                }
+            }
+            for (auto& box : boxes) {
+                overlaps += player.intersects(*box);
+            }
+            bruteMs += std::chrono::duration<double, std::milli>(Clock::now() - bruteStart).count();
+        }
+
+        std::cout << count << "   " << sweepMs / frames << "   " << bruteMs / bruteFrames
+                  << "   " << buildMs << "   " << pairs << "   " << overlaps << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * Compare packet ray casts (Physics5D::rayCast over a RayBatch5D) with one
+ * ray at a time through the same BVH, on random static boxes. Coherent
+ * batches fire groups of Lanes rays from one origin at nearby points, like
+ * a boss core's probes; incoherent ones fire every ray from a random point
+ * in a random direction. Fails if the two disagree on any hit.
+ */
+int benchmarkRays() {
+    using Clock = std::chrono::steady_clock;
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const int rayCount = 200000;
+    int mismatches = 0;
+
+    auto randomPoint = [&](float extent) {
+        Vec5D point;
+        for (int d = 0; d < 5; ++d) point[d] = unit(random) * extent;
+        return point;
+    };
+
+    std::cout << "boxes   rays         packets (Mrays/s)   single (Mrays/s)" << std::endl;
+    for (int count : {20, 500, 10000}) {
+        float extent = 10.0f * std::pow(static_cast<float>(count), 0.2f);
+        std::vector<std::unique_ptr<Platform5D>> boxes;
+        std::vector<GameObject5D*> statics;
+        for (int i = 0; i < count; ++i) {
+            Vec5D size;
+            for (int d = 0; d < 5; ++d) size[d] = 0.5f + unit(random) * 2.0f;
+            boxes.push_back(std::make_unique<Platform5D>(randomPoint(extent), size));
+            boxes.back()->updateBounds();
+            statics.push_back(boxes.back().get());
+        }
+        BVH5D staticIndex;
+        staticIndex.build(statics);
+
+        for (bool coherent : {true, false}) {
+            RayBatch5D batch;
+            for (int first = 0; first < rayCount; first += RayBatch5D::Lanes) {
+                Vec5D origin = randomPoint(extent);
+                Vec5D target = randomPoint(extent);
+                for (int lane = 0; lane < RayBatch5D::Lanes; ++lane) {
+                    if (!coherent) {
+                        origin = randomPoint(extent);
+                        target = randomPoint(extent);
+                    }
+                    Vec5D jitter = coherent ? (randomPoint(1.0f) - Vec5D(0.5f, 0.5f, 0.5f, 0.5f, 0.5f)) : Vec5D();
+                    batch.add(origin, (target + jitter - origin).normalized(), extent * 2.0f);
+                }
+            }
+
+            auto packetStart = Clock::now();
+            Physics5D::rayCast(batch, staticIndex);
+            double packetSeconds = std::chrono::duration<double>(Clock::now() - packetStart).count();
+
+            auto singleStart = Clock::now();
+            for (int ray = 0; ray < batch.size(); ++ray) {
+                Vec5D origin, direction;
+                for (int d = 0; d < 5; ++d) {
+                    origin[d] = batch.origin[d][ray];
+                    direction[d] = batch.direction[d][ray];
+                }
+                GameObject5D* hitObject = nullptr;
+                Vec5D hitPoint;
+                bool hit = Physics5D::rayCast(origin, direction, batch.maxDistance[ray], staticIndex,
+                                              &hitObject, &hitPoint);
+                if (hit != batch.hit(ray) ||
+                    (hit && (hitPoint - batch.hitPoint(ray)).magnitudeSquared() > 1e-6f)) {
+                    ++mismatches;
+                }
+            }
+            double singleSeconds = std::chrono::duration<double>(Clock::now() - singleStart).count();
+
+            std::cout << count << "   " << (coherent ? "coherent  " : "incoherent") << "   "
+                      << batch.size() / packetSeconds * 1e-6 << "   "
+                      << batch.size() / singleSeconds * 1e-6 << std::endl;
+        }
+    }
+
+    if (mismatches > 0) {
+        std::cerr << mismatches << " rays hit differently as packets" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    // Headless benchmarks: --bench-broadphase, --bench-rays
+    if (argc >= 2 && std::string(argv[1]) == "--bench-broadphase") {
+        return benchmarkBroadphase();
+    }
+    if (argc >= 2 && std::string(argv[1]) == "--bench-rays") {
+        return benchmarkRays();
+    }
+
+    // Headless steady-state allocation check: --alloc-check
+    if (argc >= 2 && std::string(argv[1]) == "--alloc-check") {
+        return checkAllocations();
+    }
+
+    // Headless check of the resolution controller: --resolution-check
+    if (argc >= 2 && std::string(argv[1]) == "--resolution-check") {
+        return checkDynamicResolution();
+    }
+
+    // Headless render: --raymarch <level> <out.ppm> [width height]
+    if (argc >= 4 && std::string(argv[1]) == "--raymarch") {
+        int width = (argc >= 6) ? std::atoi(argv[4]) : SCREEN_WIDTH;
+        int height = (argc >= 6) ? std::atoi(argv[5]) : SCREEN_HEIGHT;
+        if (width <= 0 || height <= 0) {
+            std::cerr << "Invalid image size" << std::endl;
+            return 1;
+        }
+        return renderHeadless(std::atoi(argv[2]), argv[3], width, height);
+    }
+
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
@@ -72,7 +432,7 @@ int main(int argc, char* argv[]) {
 
     // Initialize game
     Game game;
-    if (!game.initialize()) {
+    if (!game.initialize(SCREEN_WIDTH, SCREEN_HEIGHT)) {
         std::cerr << "Failed to initialize game" << std::endl;
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplSDL2_Shutdown();
@@ -92,23 +452,25 @@ int main(int argc, char* argv[]) {
     std::cout << "  1-0 - Direct dimension views" << std::endl;
     std::cout << "  F1/F2 - Previous/Next level" << std::endl;
     std::cout << "  ESC - Restart level" << std::endl;
+    std::cout << "  T (hold) - Rewind time" << std::endl;
     std::cout << "===========================================" << std::endl;
 
     // Game loop
+    using Clock = std::chrono::steady_clock;
     bool running = true;
-    Uint32 lastTime = SDL_GetTicks();
+    Clock::time_point lastTime = Clock::now();
+    Clock::time_point nextFrame = lastTime;
     bool showDebugUI = true;
     bool showHelp = true;
+    bool vsync = true;
+    int renderRateCap = 0;  // Frames per second; 0 = uncapped
 
     while (running) {
-        // Calculate delta time
-        Uint32 currentTime = SDL_GetTicks();
-        float deltaTime = (currentTime - lastTime) / 1000.0f;
+        // Measure the frame; the game turns it into fixed simulation steps
+        Clock::time_point currentTime = Clock::now();
+        float frameTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
 
-        // Cap delta time to prevent physics issues
-        if (deltaTime > 0.1f) deltaTime = 0.1f;
-
         // Handle events
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
@@ -134,10 +496,12 @@ int main(int argc, char* argv[]) {
         }
 
         // Update game
-        game.update(deltaTime);
+        uint64_t allocationsBefore = AllocationCounter::count();
+        game.advance(frameTime);
 
         // Render game
         game.render(SCREEN_WIDTH, SCREEN_HEIGHT);
+        uint64_t frameAllocations = AllocationCounter::count() - allocationsBefore;
 
         // Render ImGui UI
         ImGui_ImplOpenGL3_NewFrame();
@@ -169,6 +533,7 @@ int main(int argc, char* argv[]) {
             ImGui::Spacing();
             ImGui::Text("Other:");
             ImGui::BulletText("ESC - Restart level");
+            ImGui::BulletText("T (hold) - Rewind time");
             ImGui::BulletText("F1/F2 - Previous/Next level");
             ImGui::BulletText("F3 - Toggle debug UI");
             ImGui::BulletText("F4 - Toggle this help");
@@ -190,19 +555,19 @@ int main(int argc, char* argv[]) {
             
             ImGui::Separator();
             ImGui::Text("Player Position:");
-            ImGui::Text("  X: %.2f", game.player.position.x);
-            ImGui::Text("  Y: %.2f", game.player.position.y);
-            ImGui::Text("  Z: %.2f", game.player.position.z);
-            ImGui::Text("  W: %.2f", game.player.position.w);
-            ImGui::Text("  V: %.2f", game.player.position.v);
+            ImGui::Text("  X: %.2f", game.player.position().x);
+            ImGui::Text("  Y: %.2f", game.player.position().y);
+            ImGui::Text("  Z: %.2f", game.player.position().z);
+            ImGui::Text("  W: %.2f", game.player.position().w);
+            ImGui::Text("  V: %.2f", game.player.position().v);
             
             ImGui::Separator();
             ImGui::Text("Player Velocity:");
-            ImGui::Text("  X: %.2f", game.player.velocity.x);
-            ImGui::Text("  Y: %.2f", game.player.velocity.y);
-            ImGui::Text("  Z: %.2f", game.player.velocity.z);
-            ImGui::Text("  W: %.2f", game.player.velocity.w);
-            ImGui::Text("  V: %.2f", game.player.velocity.v);
+            ImGui::Text("  X: %.2f", game.player.velocity().x);
+            ImGui::Text("  Y: %.2f", game.player.velocity().y);
+            ImGui::Text("  Z: %.2f", game.player.velocity().z);
+            ImGui::Text("  W: %.2f", game.player.velocity().w);
+            ImGui::Text("  V: %.2f", game.player.velocity().v);
             
             ImGui::Separator();
             ImGui::Text("State:");
@@ -219,6 +584,76 @@ int main(int argc, char* argv[]) {
             ImGui::Text("Performance:");
             ImGui::Text("  FPS: %.1f", io.Framerate);
             ImGui::Text("  Frame Time: %.3f ms", 1000.0f / io.Framerate);
+            ImGui::Text("  Sim Steps: %d (alpha %.2f)", game.lastSubsteps, game.interpolationAlpha);
+            ImGui::Text("  Heap Allocs: %d this frame, arena %.1f of %.1f KB",
+                        static_cast<int>(frameAllocations), game.frameArena.getUsed() / 1024.0f,
+                        game.frameArena.getCapacity() / 1024.0f);
+            ImGui::SliderFloat("Sim Rate (Hz)", &game.simulationRate, 30.0f, 240.0f, "%.0f");
+            ImGui::SliderInt("Max Substeps", &game.maxSubsteps, 1, 16);
+            if (ImGui::Checkbox("VSync", &vsync)) {
+                SDL_GL_SetSwapInterval(vsync ? 1 : 0);
+            }
+            ImGui::SliderInt("Render Cap (FPS)", &renderRateCap, 0, 240, renderRateCap ? "%d" : "Off");
+            ImGui::Text("  Scene GPU: %.3f ms", game.renderer.dynamicResolution.smoothedGpuMs);
+            ImGui::Text("  Render Res: %dx%d (%.0f%%)",
+                        game.renderer.renderWidth, game.renderer.renderHeight,
+                        game.renderer.dynamicResolution.currentScale() * 100.0f);
+            ImGui::Checkbox("Dynamic Resolution", &game.renderer.dynamicResolution.enabled);
+            ImGui::SliderFloat("GPU Budget (ms)", &game.renderer.dynamicResolution.targetFrameMs, 4.0f, 33.3f, "%.1f");
+            ImGui::Checkbox("Clustered Lights", &game.renderer.useClusteredLights);
+            ImGui::Text("  Point Lights: %d", static_cast<int>(game.renderer.lighting.lights.size()));
+            ImGui::SliderInt("Portal Depth", &game.renderer.maxPortalDepth, 0, Renderer::MaxPortalDepth);
+            ImGui::Text("  Portal Views: %d", game.renderer.portalViewsRendered);
+            if (game.currentLevel) {
+                const BVH5D& staticIndex = game.currentLevel->staticIndex;
+                ImGui::Text("  Static BVH: %d objects, %d nodes",
+                            staticIndex.getPrimitiveCount(), staticIndex.getNodeCount());
+                ImGui::Text("  Load/Restart: %.3f ms, arena %.1f of %.1f KB", game.currentLevel->loadTimeMs,
+                            game.currentLevel->objectMemory.getUsed() / 1024.0f,
+                            game.currentLevel->objectMemory.getCapacity() / 1024.0f);
+                ImGui::Text("  Rewind: %.1f s kept, %.1f KB%s", game.getRewindSeconds(),
+                            game.rewind.memoryBytes() / 1024.0f, game.rewinding ? " (rewinding)" : "");
+                ImGui::Text("  Scene Graph: %d nodes, %d updated", game.currentLevel->scene.size(),
+                            game.currentLevel->scene.lastUpdated);
+                ImGui::Text("  Active: %d of %d objects",
+                            static_cast<int>(game.currentLevel->activeObjects.size()),
+                            static_cast<int>(game.currentLevel->objects.size()));
+                const EntityStore5D& entities = game.currentLevel->entities;
+                ImGui::Text("  Entities: %d (%d movers, %d pulsing, %d projectiles, %d platforms)",
+                            entities.getEntityCount(), entities.movers.rowCount(),
+                            entities.pulsers.rowCount(), entities.projectiles.rowCount(),
+                            entities.platforms.rowCount());
+                const TriggerSystem5D& triggers = game.currentLevel->triggers;
+                ImGui::Text("  Triggers: %d, %d nearby, %d tested",
+                            triggers.getTriggerCount(), triggers.getCandidateCount(), triggers.lastTests);
+                const TimerWheel5D& timers = game.currentLevel->timers;
+                ImGui::Text("  Timers: %d pending, %d fired", timers.getPendingCount(), timers.lastFired);
+                const SweepAndPrune5D& broadphase = game.currentLevel->broadphase;
+                ImGui::Text("  Broadphase: %d proxies, %d pairs, %d swaps",
+                            broadphase.getProxyCount(), broadphase.getPairCount(), broadphase.lastSwaps);
+                const SpatialHash5D& transientIndex = game.currentLevel->transientIndex;
+                ImGui::Text("  Spatial Hash: %d bodies, %d cells, %.1f KB",
+                            transientIndex.getBodyCount(), transientIndex.getCellCount(),
+                            transientIndex.memoryBytes() / 1024.0f);
+                const CollisionPipeline5D& contacts = game.currentLevel->contacts;
+                ImGui::Text("  Contacts: %d touching, %d tested, %d reused",
+                            contacts.lastContacts, contacts.lastTested, contacts.lastReused);
+                const ContactSolver5D& solver = game.currentLevel->solver;
+                ImGui::Text("  Solver: %d contacts, %d+%d iterations, residual %.1e",
+                            solver.lastContacts, solver.lastVelocityIterations,
+                            solver.lastPositionIterations, solver.lastResidual);
+                const RayBatch5D& rays = game.currentLevel->rays;
+                if (rays.size() > 0) {
+                    ImGui::Text("  Ray Batch: %d rays, %.3f ms (%.1f Mrays/s)",
+                                rays.size(), rays.lastQueryMs, rays.lastMraysPerSecond());
+                }
+            }
+            ImGui::Checkbox("SDF Raymarching", &game.renderer.useRaymarching);
+            if (game.renderer.useRaymarching) {
+                ImGui::Text("  SDF Boxes: %d  Grid Cells: %d",
+                            static_cast<int>(game.renderer.raymarcher.boxes.size()),
+                            game.renderer.raymarcher.cellCount());
+            }
             
             ImGui::End();
         }
@@ -242,6 +677,17 @@ int main(int argc, char* argv[]) {
 
         // Swap buffers
         SDL_GL_SwapWindow(window);
+
+        // Hold the render rate down if capped; simulation keeps its own rate
+        if (renderRateCap > 0) {
+            nextFrame += std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<float>(1.0f / renderRateCap));
+            Clock::time_point now = Clock::now();
+            if (nextFrame < now) nextFrame = now;
+            std::this_thread::sleep_until(nextFrame);
+        } else {
+            nextFrame = Clock::now();
+        }
     }
 
     // Cleanup